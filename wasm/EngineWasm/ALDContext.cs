@@ -1,7 +1,6 @@
 using System;
 using System.Collections.Generic;
 using System.Linq;
-using Newtonsoft.Json;
 using SlimeGrid.Logic;
 using SlimeGrid.Tools.Solver;
 
@@ -64,6 +63,11 @@ namespace SlimeGrid.Tools.ALD
         public float w_entities { get; set; } = 0.4f;
         public float w_spatial { get; set; } = 0.2f;
         public int? minSolutionEditDistance { get; set; } = null;
+        // Seen-signature gate: "exact" (HashSet) or "bloom" (ScalableBloomFilter, bounded memory
+        // for multi-million-candidate runs; a new level is wrongly dropped at most this often)
+        public string seenFilter { get; set; } = "exact";
+        public double seenFalsePositiveRate { get; set; } = 0.001;
+        public int seenInitialCapacity { get; set; } = 1 << 16;
     }
 
     public sealed class MinMax
@@ -77,21 +81,29 @@ namespace SlimeGrid.Tools.ALD
         public readonly ContextSettings Settings;
         public readonly List<Bucket> Buckets;
         public readonly Dictionary<string, Bucket> BucketByName;
-        public readonly HashSet<string> SeenSignatures = new();
+        public readonly ISignatureSet SeenSignatures;
+        public readonly FeatureSchema Schema;    // base features, then the compiled derived ids
+        public readonly DerivedFeatures Derived; // Settings.derived, compiled; parse errors in Derived.Errors
         public readonly Random Rng;
 
         public AldContext(ContextSettings settings)
         {
             Settings = settings ?? new ContextSettings();
+            Schema = FeatureSchema.Base.Extend();
+            Derived = DerivedFeatures.Compile(Settings.derived, Schema);
             Buckets = new List<Bucket>();
             BucketByName = new Dictionary<string, Bucket>(StringComparer.OrdinalIgnoreCase);
             foreach (var bc in Settings.buckets)
             {
-                var b = new Bucket(bc);
+                var b = new Bucket(bc, Schema);
                 Buckets.Add(b);
                 BucketByName[bc.name ?? ("bucket_" + Buckets.Count)] = b;
             }
             Rng = new Random();
+            var dd = Settings.dedupe ?? new DedupeSettings();
+            SeenSignatures = string.Equals(dd.seenFilter, "bloom", StringComparison.OrdinalIgnoreCase)
+                ? new ScalableBloomFilter(dd.seenFalsePositiveRate, dd.seenInitialCapacity)
+                : new ExactSignatureSet();
         }
 
         public (bool ok, string[] acceptedIn, Dictionary<string, float> scores) Insert(LevelDTO dto)
@@ -111,9 +123,9 @@ namespace SlimeGrid.Tools.ALD
             } catch {}
 
             var s = Loader.FromDTO(dto);
-            // Exact signature dedupe (reachable region)
+            // Exact signature dedupe (reachable region, up to rotation/mirror)
             var mask = InfluenceMask.Compute(s);
-            var sig = InfluenceMask.ReachableSignature(s, mask);
+            var sig = InfluenceMask.CanonicalSignature(s, mask);
             if (!SeenSignatures.Add(sig))
                 return (false, Array.Empty<string>(), new Dictionary<string, float>());
 
@@ -124,17 +136,19 @@ namespace SlimeGrid.Tools.ALD
             if (report.topSolutions == null || report.topSolutions.Count == 0)
                 return (false, Array.Empty<string>(), new Dictionary<string, float>());
 
-            var features = Heuristics.ComputeFeatures(report);
+            var features = Heuristics.ComputeFeatures(report, Schema);
             // Derived features from settings (future‑proof composite heuristics)
-            try { Heuristics.ApplyDerivedFeatures(features, Settings.derived); } catch {}
+            Derived.Apply(features);
             var acceptedNames = new List<string>();
             var perScores = new Dictionary<string, float>();
 
+            LayoutFeatures? layout = null; // shared by this level's per-bucket candidates
             foreach (var b in Buckets)
             {
-                var (raw, reject) = Heuristics.Score(b.Config, features, Settings.generator?.accept_capped_weight ?? 1.0f);
+                var (raw, reject) = b.Scorer.Score(features, Settings.generator?.accept_capped_weight ?? 1.0f);
                 if (reject) continue;
-                var cand = new LevelCandidate { dto = dto, reachableHash = sig, report = report, features = features, rawScore = raw, normalizedScore = raw };
+                var cand = new LevelCandidate { dto = dto, reachableHash = sig, report = report, features = features, rawScore = raw, normalizedScore = raw, state = s, layout = layout };
+                layout ??= Similarity.FeaturesOf(cand);
                 if (b.PassSimilarity(cand, Settings.dedupe))
                 {
                     if (b.TryInsert(cand))
@@ -147,33 +161,47 @@ namespace SlimeGrid.Tools.ALD
             return (acceptedNames.Count > 0, acceptedNames.ToArray(), perScores);
         }
 
-        public LevelDTO SelectBase()
+        // Selection pool (topK per bucket) and its alias table, rebuilt only when a bucket's
+        // contents or the selection settings change; each draw is then O(1)
+        List<LevelDTO> selectPool = new();
+        AliasTable selectTable = new(Array.Empty<double>());
+        int[] selectVersions = Array.Empty<int>();
+        int selectTopK = -1; // none built yet
+        double selectSkew;
+
+        public LevelDTO? SelectBase()
         {
-            // Pool topK entries per bucket
-            var pool = new List<(float score, LevelDTO level)>();
             int topK = Math.Max(1, Settings.selection?.topK ?? 5);
             double skew = Settings.selection?.skew ?? 1.0;
-            foreach (var b in Buckets)
-            {
-                // Sort bucket items by normalizedScore descending and take topK
-                var items = new List<LevelCandidate>(b.Items);
-                items.Sort((a, c) => c.normalizedScore.CompareTo(a.normalizedScore));
-                for (int i = 0; i < items.Count && i < topK; i++)
-                    pool.Add((items[i].normalizedScore, items[i].dto));
-            }
-            if (pool.Count == 0) return null;
-            double min = double.PositiveInfinity; foreach (var e in pool) if (e.score < min) min = e.score;
-            double eps = 1e-6;
-            var weights = new double[pool.Count]; double sum = 0;
-            for (int i = 0; i < pool.Count; i++)
+            if (!SelectionCurrent(topK, skew)) BuildSelection(topK, skew);
+            if (selectPool.Count == 0) return null;
+            return selectPool[selectTable.Next(Rng)];
+        }
+
+        bool SelectionCurrent(int topK, double skew)
+        {
+            if (topK != selectTopK || skew != selectSkew || selectVersions.Length != Buckets.Count) return false;
+            for (int i = 0; i < Buckets.Count; i++) if (Buckets[i].Version != selectVersions[i]) return false;
+            return true;
+        }
+
+        void BuildSelection(int topK, double skew)
+        {
+            selectPool = new List<LevelDTO>();
+            var scores = new List<double>();
+            selectVersions = new int[Buckets.Count];
+            for (int b = 0; b < Buckets.Count; b++)
             {
-                double basew = (pool[i].score - min) + eps; if (basew < eps) basew = eps;
-                double w = skew <= 0 ? 1.0 : Math.Pow(basew, skew);
-                weights[i] = w; sum += w;
+                var ranked = Buckets[b].Ranked;
+                for (int i = 0; i < ranked.Count && i < topK; i++)
+                {
+                    selectPool.Add(ranked[i].dto);
+                    scores.Add(ranked[i].normalizedScore);
+                }
+                selectVersions[b] = Buckets[b].Version;
             }
-            double r = Rng.NextDouble() * (sum > 0 ? sum : 1.0);
-            for (int i = 0; i < pool.Count; i++) { r -= weights[i]; if (r <= 0) return pool[i].level; }
-            return pool[pool.Count - 1].level;
+            selectTable = AliasTable.ForScores(scores, skew);
+            selectTopK = topK; selectSkew = skew;
         }
 
         public LevelDTO Mutate(LevelDTO baseDto, bool evolve)
@@ -183,15 +211,16 @@ namespace SlimeGrid.Tools.ALD
             if (steps <= 0) return baseDto;
             // decide whether this mutation will use greedy ops based on ratio
             bool useGreedy = (m.greedyRatio > 0.0) && (Rng.NextDouble() < m.greedyRatio);
-            var cur = JsonConvert.DeserializeObject<LevelDTO>(JsonConvert.SerializeObject(baseDto));
+            // Work on the in-memory model; only the result goes back to a DTO
+            var cur = LevelModel.FromDTO(baseDto);
             for (int k = 0; k < steps; k++)
             {
                 cur = MutateOnce(cur, m, useGreedy);
             }
-            return cur;
+            return cur.ToDTO();
         }
 
-        private LevelDTO MutateOnce(LevelDTO dto, MutationSettings m, bool useGreedy)
+        private LevelModel MutateOnce(LevelModel level, MutationSettings m, bool useGreedy)
         {
             // Choose operator by weights
             double greedyW = useGreedy ? (m.operatorWeights.greedyPlaceOne + m.operatorWeights.greedyRemoveOne) : 0.0;
@@ -223,8 +252,8 @@ namespace SlimeGrid.Tools.ALD
                     maxDepth = effDepth,
                     maxNodes = effNodes
                 };
-                var res = GreedyOps.PlaceOne(dto, opts);
-                return res.ok && res.level != null ? res.level : dto;
+                var (res, placed) = GreedyOps.PlaceOne(level, opts);
+                return res.ok && placed != null ? placed : level;
             }
             if (op == "greedyRemoveOne")
             {
@@ -236,14 +265,13 @@ namespace SlimeGrid.Tools.ALD
                 int effDepth = Math.Max(12, (int)Math.Round(baseDepth * depthScale));
                 int effNodes = Math.Max(2000, (int)Math.Round(baseNodes * nodesScale));
                 var opts = new GreedyOps.RemoveOneOptions { entitiesRemove = m.entitiesRemove, maxDepth = effDepth, maxNodes = effNodes };
-                var res = GreedyOps.RemoveOne(dto, opts);
-                return res.ok && res.level != null ? res.level : dto;
+                var (res, removed) = GreedyOps.RemoveOne(level, opts);
+                return res.ok && removed != null ? removed : level;
             }
 
             if (op == "replaceTile")
             {
-                var state = Loader.FromDTO(dto);
-                int W = state.Grid.W, H = state.Grid.H;
+                int W = level.W, H = level.H;
                 bool hadAllowList = (m.tilesPlace != null && m.tilesPlace.Count > 0);
                 if (hadAllowList)
                 {
@@ -252,26 +280,24 @@ namespace SlimeGrid.Tools.ALD
                         int x = Rng.Next(W), y = Rng.Next(H);
                         var name = m.tilesPlace[Rng.Next(m.tilesPlace.Count)];
                         if (!Enum.TryParse<TileType>(name, true, out var tt)) continue;
-                        var cur = state.Grid.CellRef(new V2(x, y)).Type;
-                        if (cur == tt) continue;
-                        var next = JsonConvert.DeserializeObject<LevelDTO>(JsonConvert.SerializeObject(dto));
-                        EnsureGridInitialized(next);
-                        next.tileGrid[y][x] = tt.ToString();
+                        if (level[x, y] == tt) continue;
+                        var next = level.Clone();
+                        next[x, y] = tt;
                         if (RespectsCounts(next, m)) return next;
                     }
                     // We had an allowed list and couldn't place a valid change: do NOT fallback to unrestricted operator
-                    return dto;
+                    return level;
                 }
                 // No allow-list provided: fallback to ReplaceOperator palette
-                var mask = InfluenceMask.Compute(state);
-                var ok = ReplaceOperator.TryApply(new Random(Rng.Next()), Settings.generator ?? new GeneratorSettings(), state, dto, mask, out var dtoOut);
-                return ok && dtoOut != null ? dtoOut : dto;
+                var mask = InfluenceMask.Compute(level.ToState());
+                var ok = ReplaceOperator.TryApply(new Random(Rng.Next()), Settings.generator ?? new GeneratorSettings(), level, mask, out var replaced);
+                return ok && replaced != null ? replaced : level;
             }
             if (op == "placeEntity")
             {
                 if (m.entitiesPlace != null && m.entitiesPlace.Count > 0)
                 {
-                    var state = Loader.FromDTO(dto);
+                    var state = level.ToState();
                     int W = state.Grid.W, H = state.Grid.H;
                     for (int tries = 0; tries < 16; tries++)
                     {
@@ -279,7 +305,6 @@ namespace SlimeGrid.Tools.ALD
                         var name = m.entitiesPlace[Rng.Next(m.entitiesPlace.Count)];
                         if (!Enum.TryParse<EntityType>(name, true, out var et)) continue;
                         // Player spawn: ensure tile supports player (not StopsPlayer)
-                        var cell = state.Grid.CellRef(new V2(x, y));
                         if (et == EntityType.PlayerSpawn)
                         {
                             var mask = TraitsUtil.ResolveTileMask(state, new V2(x, y));
@@ -293,104 +318,61 @@ namespace SlimeGrid.Tools.ALD
                             if ((mask & Traits.HoleForEntity) != 0) continue;
                         }
                         if (state.EntityAt.ContainsKey(new V2(x, y))) continue;
-                        var next = JsonConvert.DeserializeObject<LevelDTO>(JsonConvert.SerializeObject(dto));
-                        if (next.entities == null) next.entities = new List<EntityDTO>();
-                        // Ensure uniqueness of PlayerSpawn
-                        if (et == EntityType.PlayerSpawn) next.entities.RemoveAll(e => e.type == EntityType.PlayerSpawn);
-                        next.entities.Add(new EntityDTO { type = et, x = x, y = y });
+                        var next = level.Clone();
+                        // AddEntity keeps PlayerSpawn unique
+                        next.AddEntity(et, x, y);
                         if (RespectsCounts(next, m)) return next;
                     }
                 }
-                return dto;
+                return level;
             }
             if (op == "removeEntity")
             {
-                var list = dto.entities ?? new List<EntityDTO>();
-                var candidates = list.Where(e => e != null && m.entitiesRemove.Contains(e.type.ToString())).ToList();
+                var candidates = level.Entities.Where(e => m.entitiesRemove.Contains(e.type.ToString())).ToList();
                 if (candidates.Count > 0)
                 {
                     var e = candidates[Rng.Next(candidates.Count)];
-                    var next = JsonConvert.DeserializeObject<LevelDTO>(JsonConvert.SerializeObject(dto));
-                    var l2 = next.entities ?? new List<EntityDTO>();
-                    l2.RemoveAll(x => x.x == e.x && x.y == e.y && x.type == e.type);
-                    next.entities = l2;
-                    if (RespectsCounts(next, m)) return next; else return dto;
+                    var next = level.Clone();
+                    next.Entities.RemoveAll(x => x.x == e.x && x.y == e.y && x.type == e.type);
+                    if (RespectsCounts(next, m)) return next; else return level;
                 }
-                return dto;
+                return level;
             }
 
             // default fallback to ReplaceOperator if unknown
             {
-                var state = Loader.FromDTO(dto);
-                var mask = InfluenceMask.Compute(state);
-                var ok = ReplaceOperator.TryApply(new Random(Rng.Next()), Settings.generator ?? new GeneratorSettings(), state, dto, mask, out var dtoOut);
-                return ok && dtoOut != null ? dtoOut : dto;
-            }
-        }
-
-        private static void EnsureGridInitialized(LevelDTO dto)
-        {
-            if (dto.tileGrid != null && dto.tileGrid.Length > 0) return;
-            dto.tileGrid = new string[dto.height][];
-            for (int y = 0; y < dto.height; y++)
-            {
-                dto.tileGrid[y] = new string[dto.width];
-                for (int x = 0; x < dto.width; x++) dto.tileGrid[y][x] = TileType.Floor.ToString();
+                var mask = InfluenceMask.Compute(level.ToState());
+                var ok = ReplaceOperator.TryApply(new Random(Rng.Next()), Settings.generator ?? new GeneratorSettings(), level, mask, out var replaced);
+                return ok && replaced != null ? replaced : level;
             }
         }
 
-        private bool RespectsCounts(LevelDTO dto, MutationSettings m)
+        private bool RespectsCounts(LevelModel level, MutationSettings m)
         {
             // Tiles count
-            if (m.tileCounts != null)
+            if (m.tileCounts != null && m.tileCounts.Count > 0)
             {
-                var counts = CountTiles(dto);
+                var counts = new int[256];
+                foreach (var t in level.Tiles) counts[(int)t]++;
                 foreach (var kv in m.tileCounts)
                 {
-                    counts.TryGetValue(kv.Key, out var val);
+                    int val = Enum.TryParse<TileType>(kv.Key, true, out var tt) ? counts[(int)tt] : 0;
                     if (kv.Value.min.HasValue && val < kv.Value.min.Value) return false;
                     if (kv.Value.max.HasValue && val > kv.Value.max.Value) return false;
                 }
             }
-            if (m.entityCounts != null)
+            if (m.entityCounts != null && m.entityCounts.Count > 0)
             {
-                var counts = CountEntities(dto);
+                var counts = new int[256];
+                foreach (var e in level.Entities) counts[(int)e.type]++;
                 foreach (var kv in m.entityCounts)
                 {
-                    counts.TryGetValue(kv.Key, out var val);
+                    int val = Enum.TryParse<EntityType>(kv.Key, true, out var et) ? counts[(int)et] : 0;
                     if (kv.Value.min.HasValue && val < kv.Value.min.Value) return false;
                     if (kv.Value.max.HasValue && val > kv.Value.max.Value) return false;
                 }
             }
             return true;
         }
-
-        private Dictionary<string, int> CountTiles(LevelDTO dto)
-        {
-            var d = new Dictionary<string, int>(StringComparer.OrdinalIgnoreCase);
-            if (dto.tileGrid != null)
-            {
-                for (int y = 0; y < dto.tileGrid.Length; y++)
-                {
-                    var row = dto.tileGrid[y]; if (row == null) continue;
-                    for (int x = 0; x < row.Length; x++)
-                    {
-                        var name = row[x] ?? TileType.Floor.ToString();
-                        d.TryGetValue(name, out var c); d[name] = c + 1;
-                    }
-                }
-            }
-            return d;
-        }
-
-        private Dictionary<string, int> CountEntities(LevelDTO dto)
-        {
-            var d = new Dictionary<string, int>(StringComparer.OrdinalIgnoreCase);
-            foreach (var e in dto.entities ?? new List<EntityDTO>())
-            {
-                var name = e.type.ToString(); d.TryGetValue(name, out var c); d[name] = c + 1;
-            }
-            return d;
-        }
     }
 }
@@ -28,6 +28,7 @@ namespace SlimeGrid.Tools.ALD
         public float T_sol = 0.12f;     // solution similarity gate
         public float T_layout = 0.25f;  // layout similarity gate
         public float w_tiles = 0.4f, w_entities = 0.4f, w_spatial = 0.2f;
+        public int indexAbove = 256;    // PassSimilarity scans kept items up to this count, then queries the LSH index
     }
 
     [Serializable]
@@ -41,7 +42,9 @@ namespace SlimeGrid.Tools.ALD
         public float accept_capped_weight = 0.8f;
         public float p_ignoreExitRule = 0.1f;
         public int spatialHashSize = 8;
-        public int parallelism = 4;
+        public int parallelism = 4;       // solver workers
+        public int producers = 1;         // mutation threads feeding them
+        public int queueCapacity = 0;     // per pipeline stage; 0 = 2 * parallelism
         public List<BucketConfig> buckets = new();
     }
 
@@ -57,10 +60,16 @@ namespace SlimeGrid.Tools.ALD
     public sealed class LevelCandidate
     {
         public LevelDTO dto;               // authoring state
-        public string reachableHash;       // dedupe
+        public ulong reachableHash;        // dedupe (InfluenceMask.CanonicalSignature)
         public SlimeGrid.Tools.Solver.SolverReport report; // solver output
-        public Dictionary<string, float> features = new(); // computed values
+        public float[] features = Array.Empty<float>(); // computed values, by FeatureSchema slot
         public float rawScore;
         public float normalizedScore;
+
+        // Similarity inputs, filled on first comparison (Similarity.FeaturesOf / TopSolutionOf)
+        public GameState? state;
+        public LayoutFeatures? layout;
+        public SlimeGrid.Tools.Solver.PackedMoves topSolution;
+        public ulong[]? bandKeys; // SimilarityIndex
     }
 }
@@ -0,0 +1,66 @@
+using System;
+using System.Collections.Generic;
+
+namespace SlimeGrid.Tools.ALD
+{
+    // Walker's alias method (Vose's construction): O(n) to build, O(1) per draw from a fixed
+    // discrete distribution. Build once per distribution, draw many times.
+    public sealed class AliasTable
+    {
+        readonly double[] prob;
+        readonly int[] alias;
+
+        public int Count => prob.Length;
+
+        // Non-negative weights; all zero draws uniformly
+        public AliasTable(IReadOnlyList<double> weights)
+        {
+            int n = weights.Count;
+            prob = new double[n];
+            alias = new int[n];
+            if (n == 0) return;
+            double sum = 0;
+            for (int i = 0; i < n; i++) sum += weights[i];
+
+            var scaled = new double[n];
+            var small = new Stack<int>();
+            var large = new Stack<int>();
+            for (int i = 0; i < n; i++)
+            {
+                scaled[i] = sum > 0 ? weights[i] * n / sum : 1.0;
+                (scaled[i] < 1.0 ? small : large).Push(i);
+            }
+            while (small.Count > 0 && large.Count > 0)
+            {
+                int s = small.Pop(), l = large.Pop();
+                prob[s] = scaled[s];
+                alias[s] = l;
+                scaled[l] = scaled[l] + scaled[s] - 1.0;
+                (scaled[l] < 1.0 ? small : large).Push(l);
+            }
+            // Leftovers are 1 up to rounding
+            while (large.Count > 0) { int l = large.Pop(); prob[l] = 1.0; alias[l] = l; }
+            while (small.Count > 0) { int s = small.Pop(); prob[s] = 1.0; alias[s] = s; }
+        }
+
+        // Base selection weights: (score - min + eps)^skew, uniform when skew <= 0
+        public static AliasTable ForScores(IReadOnlyList<double> scores, double skew)
+        {
+            double min = double.PositiveInfinity; foreach (var s in scores) if (s < min) min = s;
+            double eps = 1e-6;
+            var weights = new double[scores.Count];
+            for (int i = 0; i < scores.Count; i++)
+            {
+                double basew = (scores[i] - min) + eps; if (basew < eps) basew = eps;
+                weights[i] = skew <= 0 ? 1.0 : Math.Pow(basew, skew);
+            }
+            return new AliasTable(weights);
+        }
+
+        public int Next(Random rng)
+        {
+            int i = rng.Next(prob.Length);
+            return rng.NextDouble() < prob[i] ? i : alias[i];
+        }
+    }
+}
@@ -8,27 +8,28 @@ namespace SlimeGrid.Logic.Animation
     {
         // ---- Movement (authoritative inputs for the runtime animator) ----
 
-        public static void PlayerMove(StepResult r, V2 from, V2 to, Dir dir, string kind)
+        public static void PlayerMove<TSink>(ref TSink r, V2 from, V2 to, Dir dir, string kind) where TSink : IStepSink
         {
+            if (!r.Records) return;
             int tiles = Math.Abs(to.x - from.x) + Math.Abs(to.y - from.y);
             // Player id = -1 by convention
             r.Add(new MoveStraight(-1, from, to, dir, tiles, kind));
         }
 
-        public static void EntityMove(StepResult r, int entityId, V2 from, V2 to, string kind)
+        public static void EntityMove<TSink>(ref TSink r, int entityId, V2 from, V2 to, string kind) where TSink : IStepSink
         {
-            r.Add(new MoveEntity(entityId, from, to, kind));
+            if (r.Records) r.Add(new MoveEntity(entityId, from, to, kind));
         }
 
         // ---- One-shot cues (SFX/VFX; motion is driven by Move* above) ----
 
-        public static void Bump(StepResult r, V2 at)
-            => r.Add(new AnimationCue(CueType.Bump, at, CueTime.Bump));
+        public static void Bump<TSink>(ref TSink r, V2 at) where TSink : IStepSink
+        { if (r.Records) r.Add(new AnimationCue(CueType.Bump, at, CueTime.Bump)); }
 
-        public static void BreakImpact(StepResult r, V2 at)
-            => r.Add(new AnimationCue(CueType.BreakImpact, at, CueTime.Break));
+        public static void BreakImpact<TSink>(ref TSink r, V2 at) where TSink : IStepSink
+        { if (r.Records) r.Add(new AnimationCue(CueType.BreakImpact, at, CueTime.Break)); }
 
-        public static void SetAttachment(StepResult r, int? id, Dir? entry)
-            => r.Add(new SetAttachment(id, entry));
+        public static void SetAttachment<TSink>(ref TSink r, int? id, Dir? entry) where TSink : IStepSink
+        { if (r.Records) r.Add(new SetAttachment(id, entry)); }
     }
 }
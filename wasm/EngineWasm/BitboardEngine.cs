@@ -0,0 +1,470 @@
+#if (UNITY_EDITOR || EXPOSE_WASM) && NET7_0_OR_GREATER
+using System;
+using System.Numerics;
+using SlimeGrid.Logic;
+
+namespace SlimeGrid.Tools.Solver
+{
+    // Search state for BitboardLevel<T>. Entity slots keep the root's EntitiesById order
+    // (falls and expansion walk them the same way); Occupied mirrors Pos as one bitboard.
+    public struct BoardState<T> where T : unmanaged, IBinaryInteger<T>
+    {
+        public const byte Gone = 0xFF;
+
+        public byte[] Pos;          // cell index per slot, Gone once removed
+        public T Occupied;
+        public byte Player;
+        public sbyte Attached;      // slot index, -1 => free
+        public sbyte EntryDir;      // -1 => none (on top)
+        public bool AnyButtonPressed;
+        public bool LastAnyButtonPressed;
+        public bool GameOver;
+        public bool Win;
+    }
+
+    // Engine.Step over bit planes for levels of at most 64 (ulong) or 128 (UInt128) cells.
+    // T is a struct type argument, so each board size class gets its own specialized code.
+    // Cell i = y*W + x; a single-bit board is one cell and Shift() moves it, yielding zero
+    // when it leaves the grid (zero then reads like ResolveTileMask's out-of-bounds mask).
+    // Only levels whose tiles depend on button parity alone are accepted (no presence
+    // toggles, static buttons, one entity per cell); everything else stays on GameState.
+    public sealed class BitboardLevel<T> where T : unmanaged, IBinaryInteger<T>
+    {
+        const Traits OutOfBounds = Traits.StopsPlayer | Traits.StopsEntity | Traits.StopsFlight;
+
+        readonly GameState template;
+        readonly MoveTables moves;       // handed to expanded states so analyzers keep the fast path
+        readonly int W;
+        readonly T board, notFirstCol, notLastCol;
+        readonly T[] planes;             // [traitBit*2 + buttonPressed] => cells with that tile trait
+        readonly T buttonToggle, buttonAllowExit;
+
+        // Per-slot entity data (immutable while searching)
+        readonly int[] ids;
+        readonly EntityType[] types;
+        readonly Traits[] traits;
+        readonly BehaviorId[] behaviors;
+        readonly Orientation[] orientations;
+        readonly int[] pressers;         // slots with PressesButtons
+
+        public readonly BoardState<T> Root;
+
+        BitboardLevel(GameState s)
+        {
+            template = s;
+            var g = s.Grid;
+            moves = MoveTables.TryBuild(g)!; // TryCreate refuses the same dynamic toggles
+            var lvl = g.Compiled;
+            W = g.W;
+            planes = new T[64 * 2];
+            for (int i = 0; i < g.W * g.H; i++)
+            {
+                var cell = T.One << i;
+                board |= cell;
+                if (i % W != 0) notFirstCol |= cell;
+                if (i % W != W - 1) notLastCol |= cell;
+                for (int p = 0; p < 2; p++)
+                {
+                    ulong m = (ulong)lvl.ButtonPlane(i, p == 1);
+                    while (m != 0)
+                    {
+                        int b = BitOperations.TrailingZeroCount(m);
+                        planes[(b << 1) | p] |= cell;
+                        m &= m - 1;
+                    }
+                }
+            }
+            buttonToggle = Plane(Traits.ButtonToggle, false);
+            buttonAllowExit = Plane(Traits.ButtonAllowExit, false);
+
+            int n = s.EntitiesById.Count;
+            ids = new int[n]; types = new EntityType[n]; traits = new Traits[n];
+            behaviors = new BehaviorId[n]; orientations = new Orientation[n];
+            var root = new BoardState<T>
+            {
+                Pos = new byte[n],
+                Player = (byte)Index(s.PlayerPos),
+                Attached = -1,
+                EntryDir = s.EntryDir.HasValue ? (sbyte)s.EntryDir.Value : (sbyte)-1,
+                AnyButtonPressed = s.AnyButtonPressed,
+                LastAnyButtonPressed = s.LastAnyButtonPressed,
+                GameOver = s.GameOver,
+                Win = s.Win,
+            };
+            int k = 0, np = 0;
+            foreach (var e in s.EntitiesById.Values)
+            {
+                ids[k] = e.Id; types[k] = e.Type; traits[k] = e.Traits;
+                behaviors[k] = e.Behavior; orientations[k] = e.Orientation;
+                root.Pos[k] = (byte)Index(e.Pos);
+                root.Occupied |= T.One << root.Pos[k];
+                if (s.AttachedEntityId == e.Id) root.Attached = (sbyte)k;
+                if ((e.Traits & Traits.PressesButtons) != 0) np++;
+                k++;
+            }
+            pressers = new int[np];
+            for (k = 0, np = 0; k < n; k++)
+                if ((traits[k] & Traits.PressesButtons) != 0) pressers[np++] = k;
+            Root = root;
+        }
+
+        // Null when the level does not fit this board size or needs GameState-only rules.
+        public static BitboardLevel<T>? TryCreate(GameState s)
+        {
+            var g = s.Grid;
+            if (g == null || g.W * g.H > BoardBits) return null;
+            var lvl = g.Compiled;
+            if (!lvl.ButtonsStatic) return null;
+            foreach (var word in lvl.Dynamic) if (word != 0) return null;
+            if (!g.InBounds(s.PlayerPos)) return null;
+            if (s.EntitiesById.Count != s.EntityAt.Count || s.EntitiesById.Count > sbyte.MaxValue) return null;
+            foreach (var e in s.EntitiesById.Values)
+                if (!g.InBounds(e.Pos) || !s.EntityAt.TryGetValue(e.Pos, out var id) || id != e.Id) return null;
+            if (s.AttachedEntityId is int a && (!s.EntitiesById.TryGetValue(a, out var att) || !att.Pos.Equals(s.PlayerPos))) return null;
+            return new BitboardLevel<T>(s);
+        }
+
+        static int BoardBits => System.Runtime.CompilerServices.Unsafe.SizeOf<T>() * 8;
+
+        // -------------------- step --------------------
+
+        public BoardState<T> Step(in BoardState<T> parent, Dir d)
+        {
+            var s = parent;
+            s.Pos = (byte[])parent.Pos.Clone();
+
+            bool ok = Decide(in s, d) switch
+            {
+                Verb.Walk => Walk(ref s, d),
+                Verb.PushChain => s.Attached >= 0 && PushChain(ref s, s.Attached, d),
+                Verb.Tumble => s.Attached >= 0 && Tumble(ref s, d),
+                Verb.Fly => Fly(ref s, d),
+                _ => false
+            };
+            if (!ok) return s;
+
+            s.AnyButtonPressed = (buttonToggle & Pressers(in s)) != T.Zero;
+            s.LastAnyButtonPressed = s.AnyButtonPressed;
+            Resolve(ref s, d);
+            return s;
+        }
+
+        // Decisions.Decide, one behavior per case
+        Verb Decide(in BoardState<T> s, Dir d)
+        {
+            if (s.Attached < 0) return Verb.Walk;
+            int ed = s.EntryDir;
+            switch (behaviors[s.Attached])
+            {
+                case BehaviorId.Basic:
+                    return ed >= 0 && (int)d == ed ? Verb.Fly : Verb.PushChain;
+
+                case BehaviorId.Triangle:
+                {
+                    var faces = orientations[s.Attached].ToTri().FaceDirs();
+                    if (ed < 0) return Verb.PushChain;
+                    if (ed == (int)faces.a || ed == (int)faces.b)
+                        return (d == faces.a || d == faces.b) ? Verb.Fly : Verb.PushChain;
+                    return (int)d == ed ? Verb.Fly : Verb.PushChain;
+                }
+
+                case BehaviorId.Tipping:
+                {
+                    var next = Shift(Cell(s.Player), d);
+                    if (ed < 0) return TileHas(in s, next, Traits.StopsTumble) ? Verb.Fail : Verb.Tumble;
+                    if ((int)d == ed) return Verb.Fly;
+                    return TileHas(in s, next, Traits.StopsTumble) ? Verb.PushChain : Verb.Tumble;
+                }
+
+                default:
+                    return Verb.Fail;
+            }
+        }
+
+        bool Walk(ref BoardState<T> s, Dir d)
+        {
+            var cur = Shift(Cell(s.Player), d);
+            // A blocked first cell also fails Mechanics' single-step fallback
+            if (Has(in s, cur, Traits.StopsPlayer)) return false;
+            while (Has(in s, cur, Traits.Slipery) && (s.Occupied & cur) == T.Zero
+                   && !Has(in s, Shift(cur, d), Traits.StopsPlayer))
+                cur = Shift(cur, d);
+            s.Player = (byte)Index(cur);
+            return true;
+        }
+
+        bool PushChain(ref BoardState<T> s, int rootSlot, Dir d)
+        {
+            Span<int> chain = stackalloc int[s.Pos.Length];
+            int n = 0;
+            var cur = Cell(s.Pos[rootSlot]);
+            for (int k; (k = SlotAt(in s, cur)) >= 0 && (traits[k] & Traits.Pushable) != 0; cur = Shift(cur, d))
+                chain[n++] = k;
+            if (n == 0) return false;
+
+            var first = Cell(s.Pos[chain[0]]);
+            if (Has(in s, first, Traits.SticksEntity)) return false;
+            if (Has(in s, cur, Traits.StopsEntity)) return false;
+            if (TileHas(in s, first, Traits.Slipery) && n > 1) return false;
+            for (int i = n - 1; i >= 0; i--)
+                if (Has(in s, Cell(s.Pos[chain[i]]), Traits.StopsEntity | Traits.SticksEntity)) return false;
+
+            // Back to front; a slide that cannot start is also a failed single push step
+            for (int i = n - 1; i >= 0; i--) SlideEntity(ref s, chain[i], d);
+            return true;
+        }
+
+        void SlideEntity(ref BoardState<T> s, int slot, Dir d)
+        {
+            var from = Cell(s.Pos[slot]);
+            var cur = Shift(from, d);
+            if (Has(in s, cur, Traits.StopsEntity) || (s.Occupied & cur) != T.Zero) return;
+            for (var next = Shift(cur, d);
+                 Has(in s, cur, Traits.Slipery) && !Has(in s, next, Traits.StopsEntity) && (s.Occupied & next) == T.Zero;
+                 next = Shift(cur, d))
+                cur = next;
+            Move(ref s, slot, from, cur);
+        }
+
+        bool Tumble(ref BoardState<T> s, Dir d)
+        {
+            int slot = s.Attached;
+            var cur = Cell(s.Pos[slot]);
+            var to = Shift(cur, d);
+
+            if (Has(in s, to, Traits.StopsTumble) && s.EntryDir < 0) return false;
+            if (Has(in s, cur, Traits.Slipery)) return PushChain(ref s, slot, d);
+            if (Has(in s, to, Traits.StopsEntity)) return false;
+            if (Has(in s, to, Traits.StopsTumble)) return PushChain(ref s, slot, d);
+
+            bool slides = Has(in s, to, Traits.Slipery);
+            if ((s.Occupied & to) == T.Zero)
+            {
+                Move(ref s, slot, cur, to);
+                if (s.EntryDir < 0) s.EntryDir = (sbyte)d;
+                else if ((int)d == s.EntryDir || (int)d.Opposite() == s.EntryDir) s.EntryDir = -1;
+            }
+            return !slides || PushChain(ref s, slot, d);
+        }
+
+        // Breakables strictly between start and landing are removed, as in Mechanics.Fly
+        bool Fly(ref BoardState<T> s, Dir d)
+        {
+            var from = Cell(s.Player);
+            var cur = from;
+            while (true)
+            {
+                var next = Shift(cur, d);
+                if (Has(in s, next, Traits.StopsFlight)) break;
+                cur = next;
+                if (Has(in s, next, Traits.SticksFlight)) break;
+            }
+            if (cur == from) return false;
+
+            s.Player = (byte)Index(cur);
+            s.Attached = -1;
+            s.EntryDir = -1;
+            for (var c = Shift(from, d); c != cur; c = Shift(c, d))
+            {
+                int k = SlotAt(in s, c);
+                if (k < 0 || !Has(in s, c, Traits.Breakable)) continue;
+                s.Occupied &= ~c;
+                s.Pos[k] = BoardState<T>.Gone;
+            }
+            return true;
+        }
+
+        // Engine.ResolveState: attach, entity falls (slot order), player fall, win
+        void Resolve(ref BoardState<T> s, Dir d)
+        {
+            var player = Cell(s.Player);
+            int at = SlotAt(in s, player);
+            if (at >= 0 && (traits[at] & Traits.Attachable) != 0 && s.Attached != at)
+            {
+                s.Attached = (sbyte)at;
+                s.EntryDir = (sbyte)d.Opposite();
+            }
+
+            var holes = Plane(Traits.HoleForEntity, s.AnyButtonPressed);
+            if ((s.Occupied & holes) != T.Zero)
+            {
+                for (int k = 0; k < s.Pos.Length; k++)
+                {
+                    if (s.Pos[k] == BoardState<T>.Gone || (Cell(s.Pos[k]) & holes) == T.Zero) continue;
+                    s.Occupied &= ~Cell(s.Pos[k]);
+                    s.Pos[k] = BoardState<T>.Gone;
+                    if (s.Attached == k)
+                    {
+                        s.GameOver = true;
+                        s.Attached = -1;
+                        return;
+                    }
+                }
+            }
+
+            if (s.Attached < 0 && TileHas(in s, player, Traits.HoleForPlayer))
+            {
+                s.GameOver = true;
+                return;
+            }
+
+            if (TileHas(in s, player, Traits.ExitPlayer) && s.Attached < 0
+                && (buttonAllowExit & ~Pressers(in s)) == T.Zero)
+                s.Win = true;
+        }
+
+        // -------------------- masks --------------------
+
+        T Cell(int i) => T.One << i;
+        static int Index(T cell) => int.CreateTruncating(T.TrailingZeroCount(cell));
+        int Index(V2 p) => p.y * W + p.x;
+        V2 At(int i) => new V2(i % W, i / W);
+
+        T Shift(T cell, Dir d) => d switch
+        {
+            Dir.N => (cell << W) & board,
+            Dir.S => cell >>> W,
+            Dir.E => (cell << 1) & notFirstCol,
+            _ => (cell >>> 1) & notLastCol
+        };
+
+        T Plane(Traits t, bool pressed) => planes[(BitOperations.TrailingZeroCount((ulong)t) << 1) | (pressed ? 1 : 0)];
+
+        // ResolveTileMask for any bit of t on a single-cell board
+        bool TileHas(in BoardState<T> s, T cell, Traits t)
+        {
+            if (cell == T.Zero) return (t & OutOfBounds) != 0;
+            for (ulong m = (ulong)t; m != 0; m &= m - 1)
+                if ((planes[(BitOperations.TrailingZeroCount(m) << 1) | (s.AnyButtonPressed ? 1 : 0)] & cell) != T.Zero) return true;
+            return false;
+        }
+
+        // ResolveEffectiveMask: tile planes, then the traits of an entity on the cell
+        bool Has(in BoardState<T> s, T cell, Traits t)
+        {
+            if (TileHas(in s, cell, t)) return true;
+            int k = SlotAt(in s, cell);
+            return k >= 0 && (traits[k] & t) != 0;
+        }
+
+        int SlotAt(in BoardState<T> s, T cell)
+        {
+            if ((s.Occupied & cell) == T.Zero) return -1;
+            int i = Index(cell);
+            for (int k = 0; k < s.Pos.Length; k++) if (s.Pos[k] == i) return k;
+            return -1;
+        }
+
+        T Pressers(in BoardState<T> s)
+        {
+            T m = T.Zero;
+            foreach (var k in pressers) if (s.Pos[k] != BoardState<T>.Gone) m |= Cell(s.Pos[k]);
+            return m;
+        }
+
+        void Move(ref BoardState<T> s, int slot, T from, T to)
+        {
+            s.Occupied ^= from | to;
+            s.Pos[slot] = (byte)Index(to);
+            if (s.Attached == slot) s.Player = s.Pos[slot];
+        }
+
+        // -------------------- GameState bridge --------------------
+
+        public StateKey Key(in BoardState<T> s)
+        {
+            var active = template.Grid.Compiled.Active;
+            var z = new Zobrist();
+            z.Player(At(s.Player), s.EntryDir >= 0 ? (Dir)s.EntryDir : null, s.Attached >= 0);
+            for (int k = 0; k < s.Pos.Length; k++)
+                if (s.Pos[k] != BoardState<T>.Gone) z.Entity(types[k], At(s.Pos[k]), orientations[k]);
+            z.Buttons((buttonToggle & Pressers(in s)) != T.Zero);
+            for (int k = 0; k < s.Pos.Length; k++)
+                if (s.Pos[k] != BoardState<T>.Gone && (active[s.Pos[k]] & Traits.ToggleableByEntity) != 0) z.EntityToggle(At(s.Pos[k]));
+            if ((active[s.Player] & Traits.ToggleableByPlayer) != 0) z.PlayerToggle();
+            return z.Key;
+        }
+
+        public void Pack(in BoardState<T> s, StatePacker packer, Span<ulong> words)
+        {
+            packer.Begin();
+            for (int k = 0; k < s.Pos.Length; k++)
+                if (s.Pos[k] != BoardState<T>.Gone) packer.Add(types[k], orientations[k], s.Pos[k]);
+            packer.Finish(s.Player, s.Attached >= 0, s.EntryDir >= 0 ? (Dir)s.EntryDir : null, words);
+        }
+
+        // SolveGraph support (see ISearchSpace.Reach)
+        public int Reach(in BoardState<T> s, Dir d, in BoardState<T> child)
+        {
+            int px = s.Player % W, py = s.Player / W;
+            int far = SolveGraph.RayIndex(px, py, d, child.Player % W, child.Player / W);
+            for (int k = 0; k < child.Pos.Length; k++)
+            {
+                if (child.Pos[k] == s.Pos[k]) continue;
+                if (child.Pos[k] == BoardState<T>.Gone) return int.MaxValue;
+                int i = SolveGraph.RayIndex(px, py, d, child.Pos[k] % W, child.Pos[k] / W);
+                if (i < 0) return int.MaxValue;
+                far = Math.Max(far, i);
+            }
+            if (far < 0) return int.MaxValue;
+            // Shift() drops cells that leave the grid, so the run ends at the edge
+            var cell = T.One << s.Player;
+            for (int i = 0; i <= far; i++) cell = Shift(cell, d);
+            while ((cell & s.Occupied) != T.Zero) { far++; cell = Shift(cell, d); }
+            return far + 1;
+        }
+
+        public bool Reads(in BoardState<T> s, Dir d, int reach, int cell)
+        {
+            if ((s.Occupied & (T.One << cell)) != T.Zero) return true;
+            int k = SolveGraph.RayIndex(s.Player % W, s.Player / W, d, cell % W, cell / W);
+            return k >= 0 && k <= reach;
+        }
+
+        // Full GameState for analyzers that only speak GameState (ids match the root).
+        public GameState Expand(in BoardState<T> s)
+        {
+            var g = new GameState
+            {
+                Grid = template.Grid,
+                PlayerPos = At(s.Player),
+                AttachedEntityId = s.Attached >= 0 ? ids[s.Attached] : null,
+                EntryDir = s.EntryDir >= 0 ? (Dir)s.EntryDir : null,
+                LastMoveDir = template.LastMoveDir,
+                AnyButtonPressed = s.AnyButtonPressed,
+                LastAnyButtonPressed = s.LastAnyButtonPressed,
+                GameOver = s.GameOver,
+                Win = s.Win,
+                Moves = moves,
+                Occupancy = new ulong[(template.Grid.W * template.Grid.H + 63) >> 6],
+            };
+            for (int k = 0; k < s.Pos.Length; k++)
+            {
+                if (s.Pos[k] == BoardState<T>.Gone) continue;
+                var e = new Entity { Id = ids[k], Type = types[k], Pos = At(s.Pos[k]), Traits = traits[k], Orientation = orientations[k], Behavior = behaviors[k] };
+                g.EntitiesById[e.Id] = e;
+                g.EntityAt[e.Pos] = e.Id;
+                moves.Occupy(g, e.Pos);
+            }
+            return g;
+        }
+
+        // Field-by-field comparison with a GameState stepped by Engine.Step.
+        public bool Matches(GameState g, in BoardState<T> s)
+        {
+            if (!g.PlayerPos.Equals(At(s.Player)) || g.GameOver != s.GameOver || g.Win != s.Win) return false;
+            if (g.AnyButtonPressed != s.AnyButtonPressed || g.LastAnyButtonPressed != s.LastAnyButtonPressed) return false;
+            if (g.AttachedEntityId != (s.Attached >= 0 ? ids[s.Attached] : (int?)null)) return false;
+            if (g.EntryDir != (s.EntryDir >= 0 ? (Dir)s.EntryDir : (Dir?)null)) return false;
+            int alive = 0;
+            for (int k = 0; k < s.Pos.Length; k++)
+            {
+                if (s.Pos[k] == BoardState<T>.Gone) { if (g.EntitiesById.ContainsKey(ids[k])) return false; continue; }
+                if (!g.EntitiesById.TryGetValue(ids[k], out var e) || !e.Pos.Equals(At(s.Pos[k]))) return false;
+                alive++;
+            }
+            return alive == g.EntitiesById.Count;
+        }
+    }
+}
+#endif
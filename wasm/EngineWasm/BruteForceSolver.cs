@@ -15,6 +15,19 @@ namespace SlimeGrid.Tools.Solver
         public double TimeCapSeconds = 10.0;
         public bool EnforceTimeCap = false; // implemented, off by default
         public bool LightReport = true;
+        public bool PruneDeadlocks = false; // drop children with stuck boxes (changes dead-end stats)
+        public bool UseBitboard = true;     // bitboard stepping for levels of <= 128 cells (same results)
+        public bool VerifyBitboard = false; // replay every bitboard step through Engine.Step, throw on mismatch
+        // Engine path: replay every NullStepSink step with StepResult and CountingStepSink, throw
+        // on mismatch. On in debug builds, so every debug solve runs the parity check.
+#if DEBUG
+        public bool VerifyStepSink = true;
+#else
+        public bool VerifyStepSink = false;
+#endif
+        public bool ExactStateKeys = false; // visited set over exact packed states (StatePacker), no hash collisions
+        public bool CountKeyCollisions = false; // with ExactStateKeys: count distinct states sharing a Zobrist key
+        public int AbortBelowLength = 0;    // AnalyzeBfs: stop at the first solution shorter than this (caps.boundHit)
     }
 
     public static class BruteForceSolver
@@ -22,13 +35,35 @@ namespace SlimeGrid.Tools.Solver
         // Deterministic order
         static readonly Dir[] DIRS = new[] { Dir.N, Dir.E, Dir.S, Dir.W };
 
-        static bool PrefixEqual(PackedMoves a, PackedMoves b, int len)
+        // Near counts via strict prefix equality with K=5, plus the divergence histogram.
+        // One word-wise longest-common-prefix per kept top-3 solution answers both the
+        // near tests (lcp >= L-K) and where the dead-end left the closest solution line.
+        static void ComputeNearCounts(List<PackedMoves> filtered, List<PackedMoves> deadEnds, SolverReport report)
         {
+            const int K = 5;
+            int near1 = 0, near3 = 0;
+            var hist = new List<int>();
+            if (filtered.Count > 0)
+            {
+                int top3N = Math.Min(3, filtered.Count);
+                foreach (var d in deadEnds)
+                {
+                    // lcp never exceeds either length, so lcp >= pref implies both paths are long enough
+                    int lcp1 = PackedMoves.CommonPrefixLength(d, filtered[0]);
+                    int best = lcp1;
+                    for (int t = 1; t < top3N; t++) best = Math.Max(best, PackedMoves.CommonPrefixLength(d, filtered[t]));
+
+                    while (hist.Count <= best) hist.Add(0);
+                    hist[best]++;
 
-            if (len < 0) return false;
-            if (a.Length < len || b.Length < len) return false;
-            for (int i = 0; i < len; i++) if (a.GetAt(i) != b.GetAt(i)) return false;
-            return true;
+                    int L = d.Length; if (L <= K) continue; int pref = L - K;
+                    if (lcp1 >= pref) near1++;
+                    if (best >= pref) near3++;
+                }
+            }
+            report.deadEndsNearTop1Count = near1;
+            report.deadEndsNearTop3Count = near3;
+            report.deadEndsDivergenceHistogram = hist;
         }
         static void ComputeMoveStats(GameState initial, List<PackedMoves> filtered, out int stepsInBoxTop1, out int stepsFreeTop1, out int dedupLenTop1,
             out double stepsInBoxTop3Avg, out double stepsFreeTop3Avg, out double dedupLenTop3Avg)
@@ -43,6 +78,7 @@ namespace SlimeGrid.Tools.Solver
                 var pm = filtered[i];
                 // Replay moves
                 var s = CloneState(initial);
+                var sink = new NullStepSink();
                 int inBox = 0, free = 0;
                 int dedupLen = 0;
                 int lastMove = -1;
@@ -52,7 +88,7 @@ namespace SlimeGrid.Tools.Solver
                     // Dedup compressed length (count direction changes)
                     if (code != lastMove) { dedupLen++; lastMove = code; }
                     var dir = DIRS[code];
-                    Engine.Step(s, dir);
+                    Engine.Step(s, dir, ref sink);
                     if (s.AttachedEntityId != null) inBox++; else free++;
                 }
                 if (i == 0)
@@ -70,9 +106,44 @@ namespace SlimeGrid.Tools.Solver
             dedupLenTop3Avg /= k;
         }
 
-        public static SolverReport Analyze(GameState initial, SolverConfig cfg)
+        public static SolverReport Analyze(GameState initial, SolverConfig cfg) => Run(initial, cfg, bfs: false);
+
+        // Picks the state representation, then the key mode, then DFS or BFS.
+        static SolverReport Run(GameState initial, SolverConfig cfg, bool bfs, GraphRequest? graph = null)
         {
             var ctx = StateHasher.BuildLevelContext(initial.Grid);
+#if NET7_0_OR_GREATER
+            if (cfg.UseBitboard)
+            {
+                if (BitboardLevel<ulong>.TryCreate(initial) is { } b64)
+                    return Run<BoardState<ulong>, BoardSpace<ulong>>(initial, cfg, ctx, new BoardSpace<ulong>(b64, ctx, cfg.VerifyBitboard), bfs, graph);
+                if (BitboardLevel<UInt128>.TryCreate(initial) is { } b128)
+                    return Run<BoardState<UInt128>, BoardSpace<UInt128>>(initial, cfg, ctx, new BoardSpace<UInt128>(b128, ctx, cfg.VerifyBitboard), bfs, graph);
+            }
+#endif
+            return Run<GameState, EngineSpace>(initial, cfg, ctx, new EngineSpace(initial, ctx, cfg.VerifyStepSink), bfs, graph);
+        }
+
+        static SolverReport Run<TState, TSpace>(GameState initial, SolverConfig cfg, LevelContext ctx, TSpace space, bool bfs, GraphRequest? graph)
+            where TSpace : struct, ISearchSpace<TState>
+        {
+            if (!cfg.ExactStateKeys || StatePacker.TryCreate(initial) is not { } packer)
+                return bfs ? AnalyzeBfs<TState, TSpace>(initial, cfg, ctx, space, graph) : AnalyzeDfs<TState, TSpace>(initial, cfg, ctx, space);
+
+            var keys = new ExactKeys(packer, cfg.CountKeyCollisions);
+            var exact = new ExactSpace<TState, TSpace>(space, keys);
+            var report = bfs
+                ? AnalyzeBfs<TState, ExactSpace<TState, TSpace>>(initial, cfg, ctx, exact, null) // arena ids are per search
+                : AnalyzeDfs<TState, ExactSpace<TState, TSpace>>(initial, cfg, ctx, exact);
+            report.exactStatesCount = keys.Arena.Count;
+            report.exactStateBytes = packer.Bytes;
+            report.zobristCollisionCount = keys.CountsCollisions ? keys.ZobristCollisions : -1;
+            return report;
+        }
+
+        static SolverReport AnalyzeDfs<TState, TSpace>(GameState initial, SolverConfig cfg, LevelContext ctx, TSpace space)
+            where TSpace : struct, ISearchSpace<TState>
+        {
             var report = new SolverReport
             {
                 solverVersion = "bf-1",
@@ -84,7 +155,7 @@ namespace SlimeGrid.Tools.Solver
                     timeCapSeconds = cfg.TimeCapSeconds,
                     timeCapEnabled = cfg.EnforceTimeCap
                 },
-                level = new LevelHeader { width = initial.Grid.W, height = initial.Grid.H, levelHash = ComputeLevelHash(initial) }
+                level = new LevelHeader { width = initial.Grid.W, height = initial.Grid.H, levelHash = ComputeLevelHash(initial).ToString("X16") }
             };
 
             // Precheck: exit in player's wall component?
@@ -106,18 +177,22 @@ namespace SlimeGrid.Tools.Solver
             var adj = new Dictionary<StateKey, HashSet<StateKey>>(4096);
             var rev = new Dictionary<StateKey, HashSet<StateKey>>(4096);
             var deadEnds = new List<PackedMoves>(1024);
+            double sumDeadEndDepth = 0;
 
-            var rootKey = StateHasher.ComputeZobrist(initial, ctx);
+            var root = space.Root;
+            var rootKey = space.Key(root);
             visited[rootKey] = 0;
 
             int nodes = 1;
             int maxDepth = 0;
+            var deadlocks = cfg.PruneDeadlocks ? DeadlockTable.Build(initial) : null;
+            int pruned = 0;
             bool nodesHit = false, depthHit = false, timeHit = false;
             int bestSolutionLen = int.MaxValue;
 
             var path = new PackedMoves(128);
-            var stack = new Stack<Frame>(256);
-            stack.Push(new Frame(CloneState(initial), 0, false, false, rootKey));
+            var stack = new Stack<Frame<TState>>(256);
+            stack.Push(new Frame<TState>(root, 0, false, false, rootKey));
 
             while (stack.Count > 0)
             {
@@ -132,6 +207,8 @@ namespace SlimeGrid.Tools.Solver
                     if (!frame.SubtreeHasWin && frame.HadFreshChild)
                     {
                         deadEnds.Add(path.Snapshot());
+                        // Measure from the frame's own state instead of replaying the path later
+                        if (!cfg.LightReport) sumDeadEndDepth += DeadEndAnalyzer.ComputeDeadEndDepth(space.View(frame.State), ctx);
                     }
                     if (stack.Count > 0)
                     {
@@ -149,11 +226,13 @@ namespace SlimeGrid.Tools.Solver
                 stack.Push(frame); // put back with incremented index
 
                 // Apply move
-                var child = CloneState(frame.State);
-                var res = Engine.Step(child, dir);
+                var child = space.Step(frame.State, dir);
+                bool win = space.Win(child), gameOver = space.GameOver(child);
+                if (deadlocks != null && !win && !gameOver && deadlocks.IsDeadlocked(space.View(child)))
+                { pruned++; continue; }
 
                 // Compute hash to detect no-op and canonical state
-                var childKey = StateHasher.ComputeZobrist(child, ctx);
+                var childKey = space.Key(child);
                 if (childKey.Equals(frame.Key))
                 {
                     // no-op; ignore
@@ -179,7 +258,7 @@ namespace SlimeGrid.Tools.Solver
                 // Extend path
                 path.Push((byte)dir);
 
-                if (child.Win)
+                if (win)
                 {
                     // Record solution (shortest to this terminal due to visited pruning)
                     solutionsRaw.Add(path.Snapshot());
@@ -193,7 +272,7 @@ namespace SlimeGrid.Tools.Solver
                     path.Pop();
                     continue;
                 }
-                if (child.GameOver)
+                if (gameOver)
                 {
                     // Terminal but not a dead end by definition; just backtrack
                     path.Pop();
@@ -210,7 +289,7 @@ namespace SlimeGrid.Tools.Solver
                 // Continue deeper if caps allow
                 if (!(nodesHit || depthHit))
                 {
-                    stack.Push(new Frame(child, 0, false, false, childKey));
+                    stack.Push(new Frame<TState>(child, 0, false, false, childKey));
                 }
                 else
                 {
@@ -222,6 +301,7 @@ namespace SlimeGrid.Tools.Solver
             report.elapsedSeconds = sw.Elapsed.TotalSeconds;
             report.nodesExplored = nodes;
             report.maxDepthReached = maxDepth;
+            report.deadlockPrunedCount = pruned;
             report.caps.nodesHit = nodesHit;
             report.caps.depthHit = depthHit;
             report.caps.timeHit = timeHit;
@@ -253,47 +333,99 @@ namespace SlimeGrid.Tools.Solver
 
             // Dead-end metrics (count and near counts); depth skipped in LightReport
             report.deadEndsCount = deadEnds.Count;
-            if (cfg.LightReport)
+            report.deadEndsAverageDepth = !cfg.LightReport && deadEnds.Count > 0 ? sumDeadEndDepth / deadEnds.Count : 0;
+
+            ComputeNearCounts(filtered, deadEnds, report);
+
+            report.solvedTag = finished ? (filtered.Count > 0 ? "true" : "false") : "capped";
+            return report;
+        }
+
+        // Breadth-first variant prioritizing shortest paths and speed on simple levels
+        public static SolverReport AnalyzeBfs(GameState initial, SolverConfig cfg) => Run(initial, cfg, bfs: true);
+
+        // Same search, also handing back the explored graph for re-solves after a tile edit
+        // (null when the precheck fails or with ExactStateKeys).
+        public static SolverReport AnalyzeBfs(GameState initial, SolverConfig cfg, out SolveGraph? graph)
+        {
+            var req = new GraphRequest { Record = true };
+            var report = Run(initial, cfg, bfs: true, req);
+            graph = req.Recorded;
+            return report;
+        }
+
+        // Solve the level `previous` was recorded on from another spawn and/or after a one-cell
+        // tile edit (same entities): the report a fresh AnalyzeBfs gives, but children that
+        // cannot read the edited cell come from the graph instead of being stepped (stepsReused).
+        // Anything the graph does not fit is solved from scratch.
+        public static SolverReport AnalyzeBfs(GameState initial, SolverConfig cfg, SolveGraph? previous) =>
+            Run(initial, cfg, bfs: true, previous != null ? new GraphRequest { Previous = previous } : null);
+
+        // One forward enumeration from several spawns of the same level (tiles and entities as
+        // starts[0]; others are skipped): breadth-first over the union of their reachable states,
+        // up to NodesCap expansions and DepthCap moves. AnalyzeBfs(start, cfg, graph) then gives
+        // each start's report while stepping only what the enumeration did not reach.
+        public static SolveGraph? ExploreBfs(IReadOnlyList<GameState> starts, SolverConfig cfg)
+        {
+            if (starts == null || starts.Count == 0) return null;
+            var first = starts[0];
+            var ctx = StateHasher.BuildLevelContext(first.Grid);
+#if NET7_0_OR_GREATER
+            if (cfg.UseBitboard)
             {
-                report.deadEndsAverageDepth = 0;
+                if (BitboardLevel<ulong>.TryCreate(first) is { } b64)
+                    return ExploreBfs<BoardState<ulong>, BoardSpace<ulong>>(starts, cfg, new BoardSpace<ulong>(b64, ctx, cfg.VerifyBitboard));
+                if (BitboardLevel<UInt128>.TryCreate(first) is { } b128)
+                    return ExploreBfs<BoardState<UInt128>, BoardSpace<UInt128>>(starts, cfg, new BoardSpace<UInt128>(b128, ctx, cfg.VerifyBitboard));
             }
-            else
+#endif
+            return ExploreBfs<GameState, EngineSpace>(starts, cfg, new EngineSpace(first, ctx, cfg.VerifyStepSink));
+        }
+
+        static SolveGraph ExploreBfs<TState, TSpace>(IReadOnlyList<GameState> starts, SolverConfig cfg, TSpace space)
+            where TSpace : struct, ISearchSpace<TState>
+        {
+            var graph = new SolveGraph(starts[0], new Dictionary<StateKey, GraphChild<TState>[]>(4096));
+            var expansions = (Dictionary<StateKey, GraphChild<TState>[]>)graph.Expansions;
+            var seen = new HashSet<StateKey>(4096);
+            var q = new Queue<(TState state, StateKey key, int depth)>();
+            foreach (var start in starts)
             {
-                double sumDepth = 0;
-                var levelCtx = StateHasher.BuildLevelContext(initial.Grid);
-                foreach (var d in deadEnds)
-                {
-                    int dd = DeadEndAnalyzer.ComputeDeadEndDepth(initial, levelCtx, d);
-                    sumDepth += dd;
-                }
-                report.deadEndsAverageDepth = deadEnds.Count > 0 ? sumDepth / deadEnds.Count : 0;
+                if (!graph.TryFindEdit(start, out int edited) || edited >= 0) continue;
+                if (!space.TryRoot(start, out var root)) continue;
+                var key = SolveGraph.NodeKey(space.Key(root), space.Pressed(in root));
+                if (seen.Add(key)) q.Enqueue((root, key, 0));
             }
 
-            // Near counts via strict prefix equality with K=5
-            if (filtered.Count > 0 && deadEnds.Count > 0)
+            while (q.Count > 0 && expansions.Count < cfg.NodesCap)
             {
-                int K = 5;
-                var top1 = filtered[0];
-                int nearTop1 = 0, nearTop3 = 0;
-                int top3N = Math.Min(3, filtered.Count);
-                foreach (var d in deadEnds)
+                var (state, key, depth) = q.Dequeue();
+                if (depth >= cfg.DepthCap) continue;
+                var children = new GraphChild<TState>[DIRS.Length];
+                for (int di = 0; di < DIRS.Length; di++)
                 {
-                    int L = d.Length; if (L <= K) continue; int pref = L - K;
-                    if (PrefixEqual(d, top1, pref)) nearTop1++;
-                    for (int t = 0; t < top3N; t++) { if (PrefixEqual(d, filtered[t], pref)) { nearTop3++; break; } }
+                    var child = space.Step(state, DIRS[di]);
+                    var childKey = space.Key(child);
+                    bool win = space.Win(child), gameOver = space.GameOver(child);
+                    children[di] = new GraphChild<TState> { State = child, Key = childKey, Reach = space.Reach(in state, DIRS[di], in child), Win = win, GameOver = gameOver };
+                    var node = SolveGraph.NodeKey(childKey, space.Pressed(in child));
+                    if (!win && !gameOver && seen.Add(node)) q.Enqueue((child, node, depth + 1));
                 }
-                report.deadEndsNearTop1Count = nearTop1;
-                report.deadEndsNearTop3Count = nearTop3;
+                expansions[key] = children;
             }
+            return graph;
+        }
 
-            report.solvedTag = finished ? (filtered.Count > 0 ? "true" : "false") : "capped";
-            return report;
+        sealed class GraphRequest
+        {
+            public SolveGraph? Previous; // reuse its expansions
+            public bool Record;         // build Recorded from this search
+            public SolveGraph? Recorded;
         }
 
-        // Breadth-first variant prioritizing shortest paths and speed on simple levels
-        public static SolverReport AnalyzeBfs(GameState initial, SolverConfig cfg)
+        static SolverReport AnalyzeBfs<TState, TSpace>(GameState initial, SolverConfig cfg, LevelContext ctx, TSpace space, GraphRequest? graph)
+            where TSpace : struct, ISearchSpace<TState>
         {
-            var ctx = StateHasher.BuildLevelContext(initial.Grid);
             var report = new SolverReport
             {
                 solverVersion = "bf-bfs-1",
@@ -305,7 +437,7 @@ namespace SlimeGrid.Tools.Solver
                     timeCapSeconds = cfg.TimeCapSeconds,
                     timeCapEnabled = cfg.EnforceTimeCap
                 },
-                level = new LevelHeader { width = initial.Grid.W, height = initial.Grid.H, levelHash = ComputeLevelHash(initial) }
+                level = new LevelHeader { width = initial.Grid.W, height = initial.Grid.H, levelHash = ComputeLevelHash(initial).ToString("X16") }
             };
 
             if (!PrecheckHasExitReachableByWalls(initial))
@@ -324,16 +456,27 @@ namespace SlimeGrid.Tools.Solver
             var adj = new Dictionary<StateKey, HashSet<StateKey>>(4096);
             var rev = new Dictionary<StateKey, HashSet<StateKey>>(4096);
 
-            var rootKey = StateHasher.ComputeZobrist(initial, ctx);
+            var root = space.Root;
+            var rootKey = space.Key(root);
             visited[rootKey] = 0;
 
+            // Graph reuse needs the same entities and at most one edited cell (see SolveGraph)
+            Dictionary<StateKey, GraphChild<TState>[]>? reuse = null, recording = null;
+            int edited = -1, stepsReused = 0;
+            if (graph?.Previous is { } prev && !cfg.PruneDeadlocks
+                && prev.Expansions is Dictionary<StateKey, GraphChild<TState>[]> prevExp && prev.TryFindEdit(initial, out edited))
+                reuse = prevExp;
+            if (graph != null && graph.Record) recording = new Dictionary<StateKey, GraphChild<TState>[]>(4096);
+
             int nodes = 0;
             int maxDepth = 0;
-            bool nodesHit = false, depthHit = false, timeHit = false;
+            var deadlocks = cfg.PruneDeadlocks ? DeadlockTable.Build(initial) : null;
+            int pruned = 0;
+            bool nodesHit = false, depthHit = false, timeHit = false, boundHit = false;
 
-            var q = new Queue<(GameState state, StateKey key, PackedMoves path, int depth)>();
+            var q = new Queue<(TState state, StateKey key, PackedMoves path, int depth)>();
             var rootPathBfs = new PackedMoves(64);
-            q.Enqueue((CloneState(initial), rootKey, rootPathBfs, 0));
+            q.Enqueue((root, rootKey, rootPathBfs, 0));
             pathByKey[rootKey] = rootPathBfs;
 
             while (q.Count > 0)
@@ -346,11 +489,41 @@ namespace SlimeGrid.Tools.Solver
                 if (nodes >= cfg.NodesCap) { nodesHit = true; break; }
                 if (depth >= cfg.DepthCap) { depthHit = true; continue; }
 
-                foreach (var dir in DIRS)
+                GraphChild<TState>[]? reused = null, recorded = null;
+                var node = reuse != null || recording != null ? SolveGraph.NodeKey(key, space.Pressed(in state)) : key;
+                reuse?.TryGetValue(node, out reused);
+                if (recording != null) recorded = new GraphChild<TState>[DIRS.Length];
+                var from = state;
+                bool adopted = reuse == null;
+
+                for (int di = 0; di < DIRS.Length; di++)
                 {
-                    var child = CloneState(state);
-                    var _ = Engine.Step(child, dir);
-                    var childKey = StateHasher.ComputeZobrist(child, ctx);
+                    var dir = DIRS[di];
+                    TState child; bool win, gameOver;
+                    StateKey childKey = default; bool keyed = false;
+                    int reach = -1;
+                    if (reused != null && (edited < 0 || !space.Reads(in state, dir, reused[di].Reach, edited)))
+                    {
+                        ref readonly var c = ref reused[di];
+                        child = c.State; childKey = c.Key; keyed = true;
+                        win = c.Win; gameOver = c.GameOver; reach = c.Reach;
+                        stepsReused++;
+                    }
+                    else
+                    {
+                        if (!adopted) { from = space.Adopt(in state); adopted = true; }
+                        child = space.Step(from, dir);
+                        win = space.Win(child); gameOver = space.GameOver(child);
+                    }
+                    if (recorded != null)
+                    {
+                        if (!keyed) { childKey = space.Key(child); keyed = true; }
+                        if (reach < 0) reach = space.Reach(in from, dir, in child);
+                        recorded[di] = new GraphChild<TState> { State = child, Key = childKey, Reach = reach, Win = win, GameOver = gameOver };
+                    }
+                    if (deadlocks != null && !win && !gameOver && deadlocks.IsDeadlocked(space.View(child)))
+                    { pruned++; continue; }
+                    if (!keyed) childKey = space.Key(child);
                     if (childKey.Equals(key)) continue;
 
                     int newDepth = depth + 1;
@@ -362,7 +535,7 @@ namespace SlimeGrid.Tools.Solver
                     pathByKey[childKey] = next;
 
                     // Build adjacency excluding losing edges
-                    if (!child.GameOver)
+                    if (!gameOver)
                     {
                         if (!adj.TryGetValue(key, out var outs)) { outs = new HashSet<StateKey>(); adj[key] = outs; }
                         outs.Add(childKey);
@@ -370,27 +543,46 @@ namespace SlimeGrid.Tools.Solver
                         parents.Add(key);
                     }
 
-                    if (child.GameOver) continue;
-                    if (child.Win)
+                    if (gameOver) continue;
+                    if (win)
                     {
                         solutionsRaw.Add(next);
                         goals.Add(childKey);
+                        if (next.Length < cfg.AbortBelowLength) { boundHit = true; break; }
                         continue;
                     }
                     q.Enqueue((child, childKey, next, newDepth));
                 }
+                if (boundHit) break;
+                if (recording != null && recorded != null) recording[node] = recorded;
                 // Mark expanded
                 processed.Add(key);
             }
 
+            if (graph != null && recording != null) graph.Recorded = new SolveGraph(initial, recording);
+
             sw.Stop();
             report.elapsedSeconds = sw.Elapsed.TotalSeconds;
             report.nodesExplored = nodes;
             report.maxDepthReached = maxDepth;
+            report.deadlockPrunedCount = pruned;
+            report.stepsReused = stepsReused;
             report.caps.nodesHit = nodesHit;
             report.caps.depthHit = depthHit;
             report.caps.timeHit = timeHit;
 
+            if (boundHit)
+            {
+                // BFS meets solutions shortest first, so this first one is the fastest; the caller
+                // has no use for a level that solves this quickly and skips the dead-end statistics.
+                report.caps.boundHit = true;
+                var fastest = solutionsRaw[0];
+                report.solutionsTotalCount = report.solutionsFilteredCount = 1;
+                report.topSolutions.Add(new SolutionEntry { length = fastest.Length, movesPacked = fastest.Snapshot().Buffer });
+                report.solvedTag = "capped";
+                return report;
+            }
+
             bool finished = q.Count == 0 && !nodesHit && !depthHit && !timeHit;
 
             report.solutionsTotalCount = solutionsRaw.Count;
@@ -446,46 +638,20 @@ namespace SlimeGrid.Tools.Solver
             }
 
             report.deadEndsCount = deadEndKeys.Count;
-            if (cfg.LightReport)
-            {
-                report.deadEndsAverageDepth = 0;
-            }
-            else
+            // Depth = longest stay inside the unsolvable region, read off the explored graph
+            report.deadEndsAverageDepth = cfg.LightReport ? 0 : DeadEndAnalyzer.AverageDepthInRegion(adj, solvable, deadEndKeys);
             {
-                if (deadEndKeys.Count > 0)
-                {
-                    double sumLen = 0;
-                    foreach (var k in deadEndKeys)
-                    {
-                        if (pathByKey.TryGetValue(k, out var pm)) sumLen += pm.Length;
-                    }
-                    report.deadEndsAverageDepth = sumLen / deadEndKeys.Count;
-                }
-                else report.deadEndsAverageDepth = 0;
-            }
-            // Near counts via strict prefix equality with K=5
-            {
-                int near1 = 0, near3 = 0; int K = 5;
-                if (filtered.Count > 0 && deadEndKeys.Count > 0)
-                {
-                    var top1 = filtered[0]; int top3N = Math.Min(3, filtered.Count);
-                    foreach (var k in deadEndKeys)
-                    {
-                        if (!pathByKey.TryGetValue(k, out var d)) continue;
-                        int L = d.Length; if (L <= K) continue; int pref = L - K;
-                        if (PrefixEqual(d, top1, pref)) near1++;
-                        for (int t = 0; t < top3N; t++) { if (PrefixEqual(d, filtered[t], pref)) { near3++; break; } }
-                    }
-                }
-                report.deadEndsNearTop1Count = near1;
-                report.deadEndsNearTop3Count = near3;
+                var deadEndPaths = new List<PackedMoves>(deadEndKeys.Count);
+                foreach (var k in deadEndKeys)
+                    if (pathByKey.TryGetValue(k, out var d)) deadEndPaths.Add(d);
+                ComputeNearCounts(filtered, deadEndPaths, report);
             }
 
             report.solvedTag = finished ? (filtered.Count > 0 ? "true" : "false") : "capped";
             return report;
         }
 
-        static string ComputeLevelHash(GameState s)
+        static ulong ComputeLevelHash(GameState s)
         {
             unchecked
             {
@@ -494,12 +660,12 @@ namespace SlimeGrid.Tools.Solver
                     for (int x = 0; x < s.Grid.W; x++)
                     {
                         var p = new V2(x, y);
-                        var c = s.Grid.CellRef(p);
+                        ref readonly var c = ref s.Grid.CellRef(p);
                         h ^= (ulong)c.Type; h *= 1099511628211UL;
                         h ^= (ulong)c.ActiveMask; h *= 1099511628211UL;
                         if (c.InactiveMask.HasValue) { h ^= (ulong)c.InactiveMask.Value; h *= 1099511628211UL; }
                     }
-                return h.ToString("X16");
+                return h;
             }
         }
 
@@ -530,7 +696,15 @@ namespace SlimeGrid.Tools.Solver
             return hasExit;
         }
 
-        static GameState CloneState(GameState s)
+        // Search root: a private clone carrying the level's move tables; children inherit them
+        internal static GameState CloneRoot(GameState initial)
+        {
+            var root = CloneState(initial);
+            MoveTables.Attach(root);
+            return root;
+        }
+
+        internal static GameState CloneState(GameState s)
         {
             var c = new GameState
             {
@@ -543,6 +717,11 @@ namespace SlimeGrid.Tools.Solver
                 LastAnyButtonPressed = s.LastAnyButtonPressed,
                 GameOver = s.GameOver,
                 Win = s.Win,
+                Moves = s.Moves,
+                Occupancy = (ulong[]?)s.Occupancy?.Clone(),
+                PressedToggleButtons = s.PressedToggleButtons,
+                PressedAllowExitButtons = s.PressedAllowExitButtons,
+                ButtonsVersion = s.ButtonsVersion,
             };
             foreach (var kv in s.EntitiesById)
             {
@@ -565,14 +744,14 @@ namespace SlimeGrid.Tools.Solver
             return c;
         }
 
-        struct Frame
+        struct Frame<TState>
         {
-            public GameState State;
+            public TState State;
             public int NextDirIndex;
             public bool HadFreshChild;
             public bool SubtreeHasWin;
             public StateKey Key;
-            public Frame(GameState s, int next, bool hadFresh, bool subWin, StateKey key)
+            public Frame(TState s, int next, bool hadFresh, bool subWin, StateKey key)
             { State = s; NextDirIndex = next; HadFreshChild = hadFresh; SubtreeHasWin = subWin; Key = key; }
         }
     }
@@ -7,63 +7,119 @@ namespace SlimeGrid.Tools.ALD
     public sealed class Bucket
     {
         public readonly BucketConfig Config;
+        public readonly BucketScorer Scorer; // Config.features over the feature schema's slots
         // Min-heap by normalizedScore
         private readonly List<LevelCandidate> heap = new();
+        // LSH over the kept items and each item's heap position, for large buckets
+        private readonly SimilarityIndex index = new();
+        private readonly Dictionary<LevelCandidate, int> slot = new();
+        private readonly List<LevelCandidate> near = new();
+        // The same items by normalizedScore descending, kept in step with the heap
+        private readonly List<LevelCandidate> ranked = new();
 
-        public Bucket(BucketConfig cfg) { Config = cfg; }
+        public Bucket(BucketConfig cfg, FeatureSchema? schema = null)
+        {
+            Config = cfg;
+            Scorer = new BucketScorer(cfg, schema ?? FeatureSchema.Base);
+        }
 
         public IReadOnlyList<LevelCandidate> Items => heap;
+        public IReadOnlyList<LevelCandidate> Ranked => ranked;
+        // Bumped whenever the kept items change, so derived views know when to rebuild
+        public int Version { get; private set; }
 
         public bool TryInsert(LevelCandidate cand)
         {
             // If topK <= 0, treat as unlimited capacity
             if (Config.topK <= 0)
             {
-                heap.Add(cand); HeapUp(heap.Count - 1); return true;
+                Add(cand); return true;
             }
             if (heap.Count < Config.topK)
             {
-                heap.Add(cand); HeapUp(heap.Count - 1); return true;
+                Add(cand); return true;
             }
             if (heap.Count > 0 && cand.normalizedScore > heap[0].normalizedScore)
             {
-                heap[0] = cand; HeapDown(0); return true;
+                Unrank(heap[0]); index.Remove(heap[0]); slot.Remove(heap[0]);
+                heap[0] = cand; slot[cand] = 0; index.Add(cand); Rank(cand); HeapDown(0); return true;
             }
             return false;
         }
 
+        // Replaces every kept score. The map must not reorder items (e.g. a min/max
+        // normalization), since heap and rank order are left as they are.
+        public void Rescore(Func<LevelCandidate, float> score)
+        {
+            foreach (var c in heap) c.normalizedScore = score(c);
+            Version++;
+        }
+
         public bool PassSimilarity(LevelCandidate cand, DedupeSettings global)
         {
-            // First gate: solution similarity vs each kept (global thresholds)
-            foreach (var item in heap)
+            var B = Similarity.TopSolutionOf(cand);
+            float tSol = (float)(global?.T_sol ?? Config.T_sol);
+            float tLayout = (float)(global?.T_layout ?? Config.T_layout);
+            float wT = global != null ? global.w_tiles : Config.w_tiles;
+            float wE = global != null ? global.w_entities : Config.w_entities;
+            float wS = global != null ? global.w_spatial : Config.w_spatial;
+            LayoutFeatures? layoutB = null;
+
+            bool TooSimilar(LevelCandidate item)
             {
-                var A = item.report.topSolutions.Count > 0 ? Unpack(item.report.topSolutions[0]) : default;
-                var B = cand.report.topSolutions.Count > 0 ? Unpack(cand.report.topSolutions[0]) : default;
-                float solSim = Similarity.SolutionSimilarity(A, B);
-                if (solSim > (float)(global?.T_sol ?? Config.T_sol)) continue; // keep both, don't test layout
+                // First gate: solution similarity vs each kept (global thresholds)
+                float solSim = Similarity.SolutionSimilarity(Similarity.TopSolutionOf(item), B);
+                if (solSim > tSol) return false; // keep both, don't test layout
 
                 // Otherwise test layout similarity on full mask with global weights
-                var levelA = SlimeGrid.Logic.Loader.FromDTO(item.dto);
-                var levelB = SlimeGrid.Logic.Loader.FromDTO(cand.dto);
-                int N = 8;
-                var maskAll = new bool[levelA.Grid.W, levelA.Grid.H];
-                for (int y = 0; y < levelA.Grid.H; y++) for (int x = 0; x < levelA.Grid.W; x++) maskAll[x, y] = true;
-                float wT = global != null ? global.w_tiles : Config.w_tiles;
-                float wE = global != null ? global.w_entities : Config.w_entities;
-                float wS = global != null ? global.w_spatial : Config.w_spatial;
-                float lay = Similarity.LayoutSimilarity(levelA, levelB, maskAll, N, wT, wE, wS);
-                if (lay <= (float)(global?.T_layout ?? Config.T_layout))
-                {
-                    // Too similar – keep higher-scoring
-                    return cand.normalizedScore > item.normalizedScore;
-                }
+                layoutB ??= Similarity.FeaturesOf(cand);
+                return Similarity.LayoutSimilarity(Similarity.FeaturesOf(item), layoutB, wT, wE, wS) <= tLayout;
+            }
+
+            // Too similar – keep higher-scoring. The first such item in heap order decides.
+            if (heap.Count <= Config.indexAbove)
+            {
+                foreach (var item in heap)
+                    if (TooSimilar(item)) return cand.normalizedScore > item.normalizedScore;
+                return true;
+            }
+
+            // Large buckets only measure the items the index puts near the candidate
+            LevelCandidate? first = null;
+            int firstSlot = int.MaxValue;
+            foreach (var item in index.Near(cand, near))
+            {
+                int at = slot[item];
+                if (at < firstSlot && TooSimilar(item)) { first = item; firstSlot = at; }
+            }
+            return first == null || cand.normalizedScore > first.normalizedScore;
+        }
+
+        void Add(LevelCandidate cand)
+        {
+            heap.Add(cand); slot[cand] = heap.Count - 1; index.Add(cand); Rank(cand);
+            HeapUp(heap.Count - 1);
+        }
+
+        // After any equal scores, so earlier items keep their place
+        void Rank(LevelCandidate cand)
+        {
+            int lo = 0, hi = ranked.Count;
+            while (lo < hi)
+            {
+                int mid = (lo + hi) >> 1;
+                if (ranked[mid].normalizedScore >= cand.normalizedScore) lo = mid + 1; else hi = mid;
             }
-            return true;
+            ranked.Insert(lo, cand);
+            Version++;
         }
 
-        static SlimeGrid.Tools.Solver.PackedMoves Unpack(SolutionEntry e)
+        // Evictions take the minimum, which sits at the tail
+        void Unrank(LevelCandidate cand)
         {
-            return new SlimeGrid.Tools.Solver.PackedMoves { Buffer = e.movesPacked, Length = e.length };
+            for (int i = ranked.Count - 1; i >= 0; i--)
+                if (ReferenceEquals(ranked[i], cand)) { ranked.RemoveAt(i); break; }
+            Version++;
         }
 
         void HeapUp(int i)
@@ -73,6 +129,7 @@ namespace SlimeGrid.Tools.ALD
                 int p = (i - 1) >> 1;
                 if (heap[i].normalizedScore >= heap[p].normalizedScore) break;
                 (heap[i], heap[p]) = (heap[p], heap[i]);
+                slot[heap[i]] = i; slot[heap[p]] = p;
                 i = p;
             }
         }
@@ -86,6 +143,7 @@ namespace SlimeGrid.Tools.ALD
                 if (r < n && heap[r].normalizedScore < heap[s].normalizedScore) s = r;
                 if (s == i) break;
                 (heap[i], heap[s]) = (heap[s], heap[i]);
+                slot[heap[i]] = i; slot[heap[s]] = s;
                 i = s;
             }
         }
@@ -0,0 +1,54 @@
+// File: Assets/Code/Logic/ButtonCounters.cs
+// Scope: per-state pressed-button counters (incremental; replaces per-step scans)
+
+namespace SlimeGrid.Logic
+{
+    // Counts of ButtonToggle / ButtonAllowExit cells held down by PressesButtons entities.
+    // Stored on GameState, stamped with the CompiledLevel version they were counted against,
+    // and adjusted where entities move, fall or break. Tile edits bump the version and
+    // entity edits outside Engine.Step call Invalidate; either way the next read recounts.
+    // Only meaningful while the level's button bits never toggle (CompiledLevel.ButtonsStatic).
+    public static class ButtonCounters
+    {
+        public static void Invalidate(GameState s) => s.ButtonsVersion = -1;
+
+        static void EnsureCounted(GameState s)
+        {
+            var lvl = s.Grid.Compiled;
+            if (s.ButtonsVersion == lvl.Version) return;
+            int toggles = 0, allowExit = 0;
+            foreach (var e in s.EntitiesById.Values)
+            {
+                if ((e.Traits & Traits.PressesButtons) == 0) continue;
+                int i = e.Pos.y * lvl.W + e.Pos.x;
+                if (lvl.IsToggleButton(i)) toggles++;
+                if (lvl.IsAllowExitButton(i)) allowExit++;
+            }
+            s.PressedToggleButtons = toggles;
+            s.PressedAllowExitButtons = allowExit;
+            s.ButtonsVersion = lvl.Version;
+        }
+
+        // delta = -1 when a presser leaves p, +1 when it arrives; skipped while stale.
+        public static void Track(GameState s, Entity e, V2 p, int delta)
+        {
+            var lvl = s.Grid.Compiled;
+            if ((e.Traits & Traits.PressesButtons) == 0 || s.ButtonsVersion != lvl.Version) return;
+            int i = p.y * lvl.W + p.x;
+            if (lvl.IsToggleButton(i)) s.PressedToggleButtons += delta;
+            if (lvl.IsAllowExitButton(i)) s.PressedAllowExitButtons += delta;
+        }
+
+        public static bool AnyTogglePressed(GameState s)
+        {
+            EnsureCounted(s);
+            return s.PressedToggleButtons > 0;
+        }
+
+        public static bool AllAllowExitPressed(GameState s)
+        {
+            EnsureCounted(s);
+            return s.PressedAllowExitButtons == s.Grid.Compiled.AllowExitCount;
+        }
+    }
+}
@@ -0,0 +1,64 @@
+// File: Assets/Code/Logic/CompiledLevel.cs
+// Scope: flat per-level trait planes mirrored from Grid2D cells (read side of TraitsUtil)
+
+using System.Runtime.CompilerServices;
+
+namespace SlimeGrid.Logic
+{
+    // Struct-of-arrays view of the grid, kept in sync by Grid2D.SetCell (Loader and the
+    // edit ops write through it). Button parity is baked into two interleaved planes so
+    // tile resolution is one load; only cells toggled by entity/player presence (Dynamic)
+    // still look at occupancy.
+    public sealed class CompiledLevel
+    {
+        public readonly int W, H;
+        public readonly Traits[] Active;   // authored live mask
+        public readonly Traits[] Toggle;   // parity XOR mask (0 => never toggles)
+        public readonly ulong[] Dynamic;   // bit set => ToggleableByEntity/ByPlayer applies
+        readonly Traits[] planes;          // [i*2 + buttonPressed] => mask after button parity
+
+        public int Version;                // bumped on every cell write (invalidates per-state button counters)
+        public int AllowExitCount;         // cells whose authored mask has ButtonAllowExit
+        int flippingButtons;               // cells whose button bits change with toggles
+        public bool ButtonsStatic => flippingButtons == 0;
+
+        public CompiledLevel(int w, int h)
+        {
+            W = w; H = h;
+            Active = new Traits[w * h];
+            Toggle = new Traits[w * h];
+            Dynamic = new ulong[(w * h + 63) >> 6];
+            planes = new Traits[w * h * 2];
+        }
+
+        public void Refresh(int i, Cell c)
+        {
+            var a = c.ActiveMask;
+            var t = c.ToggleMask;
+
+            const Traits buttons = Traits.ButtonToggle | Traits.ButtonAllowExit;
+            AllowExitCount += ((a & Traits.ButtonAllowExit) != 0 ? 1 : 0) - ((Active[i] & Traits.ButtonAllowExit) != 0 ? 1 : 0);
+            flippingButtons += ((t & buttons) != 0 ? 1 : 0) - ((Toggle[i] & buttons) != 0 ? 1 : 0);
+            Version++;
+
+            Active[i] = a;
+            Toggle[i] = t;
+            planes[i << 1] = a;
+            planes[(i << 1) | 1] = (a & Traits.ToggleableByButton) != 0 ? a ^ t : a;
+
+            const Traits byPresence = Traits.ToggleableByEntity | Traits.ToggleableByPlayer;
+            ulong bit = 1UL << (i & 63);
+            if (t != 0 && ((a | (a ^ t)) & byPresence) != 0) Dynamic[i >> 6] |= bit;
+            else Dynamic[i >> 6] &= ~bit;
+        }
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public Traits ButtonPlane(int i, bool pressed) => planes[(i << 1) | (pressed ? 1 : 0)];
+
+        public bool IsToggleButton(int i) => (Active[i] & Traits.ButtonToggle) != 0;
+        public bool IsAllowExitButton(int i) => (Active[i] & Traits.ButtonAllowExit) != 0;
+
+        [MethodImpl(MethodImplOptions.AggressiveInlining)]
+        public bool IsDynamic(int i) => (Dynamic[i >> 6] & (1UL << (i & 63))) != 0;
+    }
+}
@@ -148,16 +148,17 @@ namespace SlimeGrid.Logic
     }
 
     // ---- Cell: runtime masks (+ metadata) -----------------------------------
+    // Value type stored inline in Grid2D; masks first, byte-sized fields packed at the end.
 
-    public sealed class Cell
+    public struct Cell
     {
-        // Metadata (debug/tools only)
-        public TileType Type;
-
         // Runtime truth used by logic:
         public Traits ActiveMask;          // current live mask
-        public Traits? InactiveMask;       // null => no alternate state
         public Traits ToggleMask; // = (InactiveMask ?? 0) ^ ActiveMask
+        public Traits? InactiveMask;       // null => no alternate state
+
+        // Metadata (debug/tools only)
+        public TileType Type;
         public bool Toggled;               // true if tile is flipped
         public Orientation? Orientation;   // null if not oriented
     }
@@ -1,4 +1,5 @@
 #if UNITY_EDITOR || EXPOSE_WASM
+using System;
 using System.Collections.Generic;
 using SlimeGrid.Logic;
 
@@ -6,24 +7,18 @@ namespace SlimeGrid.Tools.Solver
 {
     public static class DeadEndAnalyzer
     {
-        // Replays path to reach the dead-end state, then explores locally to compute
-        // the maximum further legal moves without reaching Win, stopping on local revisits.
-        public static int ComputeDeadEndDepth(GameState root, LevelContext ctx, in PackedMoves path)
+        // Explores locally from an already-reached dead-end state to compute the maximum
+        // further legal moves without reaching Win, stopping on local revisits.
+        public static int ComputeDeadEndDepth(GameState deadEnd, LevelContext ctx)
         {
-            var s = BruteForceSolverReplay.CloneState(root);
-            for (int i = 0; i < path.Length; i++)
-            {
-                var d = (Dir)path.GetAt(i);
-                Engine.Step(s, d);
-            }
-
             var localVisited = new HashSet<StateKey>(128);
-            var startKey = StateHasher.Compute(s, ctx);
+            var startKey = StateHasher.Compute(deadEnd, ctx);
             localVisited.Add(startKey);
 
             int maxDepth = 0;
             var stack = new Stack<Frame>(128);
-            stack.Push(new Frame(BruteForceSolverReplay.CloneState(s), 0, 0));
+            stack.Push(new Frame(BruteForceSolverReplay.CloneState(deadEnd), 0, 0));
+            var sink = new NullStepSink();
 
             while (stack.Count > 0)
             {
@@ -45,7 +40,7 @@ namespace SlimeGrid.Tools.Solver
                 stack.Push(f);
 
                 var child = BruteForceSolverReplay.CloneState(f.State);
-                Engine.Step(child, dir);
+                Engine.Step(child, dir, ref sink);
                 var ck = StateHasher.Compute(child, ctx);
                 if (localVisited.Contains(ck)) continue; // loop stops here
                 if (child.Win || child.GameOver) continue; // terminal stop
@@ -57,6 +52,89 @@ namespace SlimeGrid.Tools.Solver
             return maxDepth;
         }
 
+        // Graph variant for searches that keep their explored edges (AnalyzeBfs).
+        // Depth of a dead-end = longest move count from it that stays inside the unsolvable
+        // region. Strongly connected components are condensed (a component of k states
+        // contributes k-1 moves, one walk through each of its states), so every dead-end
+        // entering the same region shares one result. Tarjan emits components sinks-first,
+        // which lets the longest-path DP run in the same linear pass.
+        public static double AverageDepthInRegion(Dictionary<StateKey, HashSet<StateKey>> adj, HashSet<StateKey> solvable, HashSet<StateKey> deadEnds)
+        {
+            if (deadEnds.Count == 0) return 0;
+
+            var index = new Dictionary<StateKey, int>(deadEnds.Count * 4);
+            var succs = new List<StateKey[]>();
+            var low = new List<int>();
+            var comp = new List<int>();      // component id per node, -1 while on the Tarjan stack
+            var compDepth = new List<int>();
+            var tarjan = new Stack<int>();
+            var frames = new List<(int v, int next)>();
+
+            int Visit(StateKey k)
+            {
+                int v = succs.Count;
+                index[k] = v;
+                StateKey[] outs = Array.Empty<StateKey>();
+                if (adj.TryGetValue(k, out var set))
+                {
+                    int n = 0;
+                    foreach (var o in set) if (!solvable.Contains(o)) n++;
+                    outs = new StateKey[n];
+                    n = 0;
+                    foreach (var o in set) if (!solvable.Contains(o)) outs[n++] = o;
+                }
+                succs.Add(outs); low.Add(v); comp.Add(-1);
+                tarjan.Push(v);
+                frames.Add((v, 0));
+                return v;
+            }
+
+            foreach (var root in deadEnds)
+            {
+                if (index.ContainsKey(root)) continue;
+                Visit(root);
+                while (frames.Count > 0)
+                {
+                    var (v, next) = frames[frames.Count - 1];
+                    var outs = succs[v];
+                    if (next < outs.Length)
+                    {
+                        frames[frames.Count - 1] = (v, next + 1);
+                        if (!index.TryGetValue(outs[next], out var w)) { Visit(outs[next]); continue; }
+                        if (comp[w] < 0 && w < low[v]) low[v] = w; // w still on stack
+                        continue;
+                    }
+
+                    frames.RemoveAt(frames.Count - 1);
+                    if (frames.Count > 0)
+                    {
+                        int parent = frames[frames.Count - 1].v;
+                        if (low[v] < low[parent]) low[parent] = low[v];
+                    }
+                    if (low[v] != v) continue;
+
+                    // v roots a component: pop it, then extend the longest successor path.
+                    int c = compDepth.Count;
+                    var members = new List<int>();
+                    int x;
+                    do { x = tarjan.Pop(); comp[x] = c; members.Add(x); } while (x != v);
+
+                    int best = -1;
+                    foreach (var m in members)
+                        foreach (var o in succs[m])
+                        {
+                            int oc = comp[index[o]];
+                            if (oc != c && compDepth[oc] > best) best = compDepth[oc];
+                        }
+                    compDepth.Add(members.Count - 1 + (best >= 0 ? best + 1 : 0));
+                }
+            }
+
+            double sum = 0;
+            foreach (var k in deadEnds) sum += compDepth[comp[index[k]]];
+            return sum / deadEnds.Count;
+        }
+
         struct Frame
         {
             public GameState State;
@@ -82,6 +160,11 @@ namespace SlimeGrid.Tools.Solver
                 LastAnyButtonPressed = s.LastAnyButtonPressed,
                 GameOver = s.GameOver,
                 Win = s.Win,
+                Moves = s.Moves,
+                Occupancy = (ulong[]?)s.Occupancy?.Clone(),
+                PressedToggleButtons = s.PressedToggleButtons,
+                PressedAllowExitButtons = s.PressedAllowExitButtons,
+                ButtonsVersion = s.ButtonsVersion,
             };
             foreach (var kv in s.EntitiesById)
             {
@@ -106,5 +189,3 @@ namespace SlimeGrid.Tools.Solver
     }
 }
 #endif
-
-
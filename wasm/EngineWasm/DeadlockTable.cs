@@ -0,0 +1,150 @@
+#if UNITY_EDITOR || EXPOSE_WASM
+using System;
+using System.Collections.Generic;
+using SlimeGrid.Logic;
+
+namespace SlimeGrid.Tools.Solver
+{
+    // Static dead squares + per-state frozen boxes for levels with AllowExit buttons.
+    // Every test over-approximates what boxes can still do (both toggle parities allowed,
+    // ice stops anywhere, pushers can always get behind), so a state flagged here can
+    // never reach Win: fewer usable pressers remain than AllowExit buttons.
+    public sealed class DeadlockTable
+    {
+        readonly int W, H;
+        readonly bool[] stopsAlways;   // tile StopsEntity in both parities
+        readonly bool[] sticksAlways;  // SticksEntity without Slipery in both parities
+        readonly bool[] liveBasic;     // a pushed box (Basic/Triangle/None) can still reach an AllowExit cell
+        readonly bool[] liveTipping;   // same, but tumbling also leaves sticky cells
+        readonly V2[] allowExit;
+
+        DeadlockTable(int w, int h, V2[] buttons)
+        {
+            W = w; H = h;
+            stopsAlways = new bool[w * h];
+            sticksAlways = new bool[w * h];
+            liveBasic = new bool[w * h];
+            liveTipping = new bool[w * h];
+            allowExit = buttons;
+        }
+
+        // Returns null when the level has nothing to prune (no fixed AllowExit buttons).
+        public static DeadlockTable? Build(GameState s)
+        {
+            var g = s.Grid;
+            var lvl = g.Compiled;
+            var buttons = new List<V2>();
+            for (int i = 0; i < g.W * g.H; i++)
+            {
+                if ((lvl.Toggle[i] & Traits.ButtonAllowExit) != 0) return null; // button can vanish; stay safe
+                if ((lvl.Active[i] & Traits.ButtonAllowExit) != 0) buttons.Add(new V2(i % g.W, i / g.W));
+            }
+            if (buttons.Count == 0) return null;
+
+            var t = new DeadlockTable(g.W, g.H, buttons.ToArray());
+            var sinks = new bool[g.W * g.H];
+            for (int i = 0; i < g.W * g.H; i++)
+            {
+                var a = lvl.Active[i];
+                var b = a ^ lvl.Toggle[i];
+                t.stopsAlways[i] = (a & b & Traits.StopsEntity) != 0;
+                t.sticksAlways[i] = Sticks(a) && Sticks(b);
+                sinks[i] = (a & b & Traits.HoleForEntity) != 0;
+            }
+
+            t.FillLive(t.liveBasic, sinks, stickyBlocks: true);
+            t.FillLive(t.liveTipping, sinks, stickyBlocks: false);
+            return t;
+
+            static bool Sticks(Traits m) => (m & Traits.SticksEntity) != 0 && (m & Traits.Slipery) == 0;
+        }
+
+        // Reverse BFS from the buttons over single box moves: src -> dst needs dst enterable,
+        // src not a permanent sticky cell (unless the box tumbles) and src not a falling sink.
+        void FillLive(bool[] live, bool[] sinks, bool stickyBlocks)
+        {
+            var q = new Queue<int>();
+            foreach (var p in allowExit) { int i = p.y * W + p.x; live[i] = true; q.Enqueue(i); }
+            while (q.Count > 0)
+            {
+                int dst = q.Dequeue();
+                if (stopsAlways[dst]) continue;
+                int dx = dst % W, dy = dst / W;
+                for (int d = 0; d < 4; d++)
+                {
+                    var (vx, vy) = ((Dir)d).Vec();
+                    int sx = dx - vx, sy = dy - vy;
+                    if (sx < 0 || sy < 0 || sx >= W || sy >= H) continue;
+                    int src = sy * W + sx;
+                    if (live[src] || sinks[src] || stopsAlways[src]) continue;
+                    if (stickyBlocks && sticksAlways[src]) continue;
+                    live[src] = true;
+                    q.Enqueue(src);
+                }
+            }
+        }
+
+        bool Live(Entity e)
+        {
+            int i = e.Pos.y * W + e.Pos.x;
+            return e.Behavior == BehaviorId.Tipping ? liveTipping[i] : liveBasic[i];
+        }
+
+        // Frozen = cannot move in any direction now or later: every neighbour is a permanent
+        // stop or a frozen entity. Solved as a greatest fixed point over the entity set.
+        // Supply = pressers stuck on a button + movable pressers on live squares.
+        public bool IsDeadlocked(GameState s)
+        {
+            int need = allowExit.Length;
+            int live = 0;
+            foreach (var e in s.EntitiesById.Values)
+                if ((e.Traits & Traits.PressesButtons) != 0 && Live(e)) live++;
+            if (live < need) return true; // cheap exit: buttons are live squares too
+
+            var frozen = new HashSet<int>();
+            foreach (var e in s.EntitiesById.Values)
+                if ((e.Traits & Traits.Pushable) != 0) frozen.Add(e.Id);
+
+            var thawed = new List<int>();
+            do
+            {
+                thawed.Clear();
+                foreach (var id in frozen)
+                    if (CanMove(s, s.EntitiesById[id], frozen)) thawed.Add(id);
+                foreach (var id in thawed) frozen.Remove(id);
+            } while (thawed.Count > 0);
+
+            int supply = 0;
+            foreach (var e in s.EntitiesById.Values)
+            {
+                if ((e.Traits & Traits.PressesButtons) == 0) continue;
+                bool movable = (e.Traits & Traits.Pushable) != 0 && !frozen.Contains(e.Id);
+                if (movable ? Live(e) : IsButton(e.Pos)) supply++;
+            }
+            return supply < need;
+        }
+
+        bool IsButton(V2 p)
+        {
+            foreach (var b in allowExit) if (b.Equals(p)) return true;
+            return false;
+        }
+
+        bool CanMove(GameState s, Entity e, HashSet<int> frozen)
+        {
+            int i = e.Pos.y * W + e.Pos.x;
+            if (e.Behavior != BehaviorId.Tipping && sticksAlways[i]) return false;
+            for (int d = 0; d < 4; d++)
+            {
+                var to = e.Pos + ((Dir)d).Vec();
+                if (!s.Grid.InBounds(to) || stopsAlways[to.y * W + to.x]) continue;
+                if (!s.EntityAt.TryGetValue(to, out var other)) return true;
+                var o = s.EntitiesById[other];
+                if ((o.Traits & Traits.Breakable) != 0) return true; // may be broken by a flight later
+                if ((o.Traits & Traits.Pushable) != 0 && !frozen.Contains(other)) return true;
+            }
+            return false;
+        }
+    }
+}
+#endif
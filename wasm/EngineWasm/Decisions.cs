@@ -11,7 +11,9 @@ namespace SlimeGrid.Logic
 
     public sealed class BasicDecision : IMoveDecision
     {
-        public Verb Decide(GameState s, int entityId, Dir moveDir)
+        public Verb Decide(GameState s, int entityId, Dir moveDir) => For(s, s.EntitiesById[entityId], moveDir);
+
+        public static Verb For(GameState s, Entity e, Dir moveDir)
         {
             if (s.EntryDir.HasValue && moveDir == s.EntryDir.Value) return Verb.Fly;
             return Verb.PushChain;
@@ -20,9 +22,10 @@ namespace SlimeGrid.Logic
 
     public sealed class TriangleDecision : IMoveDecision
     {
-        public Verb Decide(GameState s, int entityId, Dir moveDir)
+        public Verb Decide(GameState s, int entityId, Dir moveDir) => For(s, s.EntitiesById[entityId], moveDir);
+
+        public static Verb For(GameState s, Entity e, Dir moveDir)
         {
-            var e = s.EntitiesById[entityId];
             var tri = e.Orientation.ToTri();
             var faces = tri.FaceDirs(); // (a,b)
 
@@ -42,9 +45,10 @@ namespace SlimeGrid.Logic
 
     public sealed class TippingDecision : IMoveDecision
     {
-        public Verb Decide(GameState s, int entityId, Dir moveDir)
+        public Verb Decide(GameState s, int entityId, Dir moveDir) => For(s, s.EntitiesById[entityId], moveDir);
+
+        public static Verb For(GameState s, Entity e, Dir moveDir)
         {
-            var e = s.EntitiesById[entityId];
             var next = e.Pos + moveDir.Vec();
 
             // ON-TOP: attempt Tumble only; if target StopsTumble => Fail (no push fallback)
@@ -88,12 +92,21 @@ namespace SlimeGrid.Logic
 
     public static class Decisions
     {
+        // Built-in behaviors are a direct switch (no dictionary lookup or interface call per
+        // step); the registry only serves ids added outside this file.
         public static Verb Decide(GameState s, Dir moveDir)
         {
             if (s.AttachedEntityId is int eid)
             {
                 var e = s.EntitiesById[eid];
-                if (e.Behavior != BehaviorId.None && MoveDecisionRegistry.Map.TryGetValue(e.Behavior, out var logic))
+                switch (e.Behavior)
+                {
+                    case BehaviorId.None: return Verb.Fail;
+                    case BehaviorId.Basic: return BasicDecision.For(s, e, moveDir);
+                    case BehaviorId.Triangle: return TriangleDecision.For(s, e, moveDir);
+                    case BehaviorId.Tipping: return TippingDecision.For(s, e, moveDir);
+                }
+                if (MoveDecisionRegistry.Map.TryGetValue(e.Behavior, out var logic))
                     return logic.Decide(s, eid, moveDir);
                 return Verb.Fail;
             }
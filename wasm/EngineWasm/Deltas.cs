@@ -94,11 +94,35 @@ namespace SlimeGrid.Logic
         { Type = type; At = at; Intensity = intensity; }
     }
 
-    public sealed class StepResult
+    // Receiver for a step's deltas. Engine/Mechanics take it as a generic parameter, so a
+    // struct sink with a constant-false Records compiles every delta allocation away.
+    public interface IStepSink
+    {
+        bool Records { get; }
+        void Add(Delta d);
+    }
+
+    // Solver/replay sink: state changes only, no deltas
+    public struct NullStepSink : IStepSink
+    {
+        public bool Records => false;
+        public void Add(Delta d) { }
+    }
+
+    // Tallies deltas without keeping them (SolverConfig.VerifyStepSink parity check)
+    public struct CountingStepSink : IStepSink
+    {
+        public int Count;
+        public bool Records => true;
+        public void Add(Delta d) => Count++;
+    }
+
+    public sealed class StepResult : IStepSink
     {
         public readonly List<Delta> Deltas = new List<Delta>();
         public bool GameOver;
         public bool Win;
+        public bool Records => true;
         public void Add(Delta d) => Deltas.Add(d);
     }
 }
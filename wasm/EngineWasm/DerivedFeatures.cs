@@ -0,0 +1,171 @@
+using System;
+using System.Collections.Generic;
+
+namespace SlimeGrid.Tools.ALD
+{
+    // Derived feature expressions (+, -, *, /, parentheses, feature ids), compiled once into
+    // stack bytecode over FeatureSchema slots. Apply then only runs the code on the feature
+    // vector. Expressions that do not parse are left out and listed in Errors; the others get
+    // a schema slot. Unknown ids read as 0; x / 0 divides by 1e-12. Later expressions see the
+    // features derived before them.
+    public sealed class DerivedFeatures
+    {
+        enum Op : byte { Const, Load, Neg, Add, Sub, Mul, Div }
+
+        readonly struct Program
+        {
+            public readonly int Slot;     // where the result goes
+            public readonly int[] Code;   // Op | arg << 8 (constant index or slot)
+            public Program(int slot, int[] code) { Slot = slot; Code = code; }
+        }
+
+        readonly List<Program> programs = new();
+        readonly List<double> consts = new();
+        readonly List<string> errors = new();
+        int maxDepth;
+
+        public IReadOnlyList<string> Errors => errors;
+        public int Count => programs.Count;
+
+        // Adds each compiled id to `schema`; vectors must be sized after this
+        public static DerivedFeatures Compile(IEnumerable<DerivedFeatureConfig> derived, FeatureSchema schema)
+        {
+            var d = new DerivedFeatures();
+            if (derived == null) return d;
+            foreach (var cfg in derived)
+            {
+                if (string.IsNullOrWhiteSpace(cfg?.id) || string.IsNullOrWhiteSpace(cfg.expr)) continue;
+                try
+                {
+                    var c = new Compiler(Tokenize(cfg.expr), d, schema);
+                    c.ParseAddSub();
+                    d.programs.Add(new Program(schema.Add(cfg.id), c.Code.ToArray()));
+                    d.maxDepth = Math.Max(d.maxDepth, c.MaxDepth);
+                }
+                catch (FormatException ex) { d.errors.Add($"{cfg.id}: {ex.Message} in \"{cfg.expr}\""); }
+            }
+            return d;
+        }
+
+        public void Apply(float[] f)
+        {
+            if (programs.Count == 0) return;
+            Span<double> stack = maxDepth <= 64 ? stackalloc double[maxDepth] : new double[maxDepth];
+            foreach (var p in programs) f[p.Slot] = (float)Run(p.Code, f, stack);
+        }
+
+        double Run(int[] code, float[] vars, Span<double> stack)
+        {
+            int sp = 0;
+            foreach (int ins in code)
+            {
+                int arg = ins >> 8;
+                switch ((Op)(ins & 0xFF))
+                {
+                    case Op.Const: stack[sp++] = consts[arg]; break;
+                    case Op.Load: stack[sp++] = vars[arg]; break;
+                    case Op.Neg: stack[sp - 1] = -stack[sp - 1]; break;
+                    case Op.Add: sp--; stack[sp - 1] += stack[sp]; break;
+                    case Op.Sub: sp--; stack[sp - 1] -= stack[sp]; break;
+                    case Op.Mul: sp--; stack[sp - 1] *= stack[sp]; break;
+                    case Op.Div: sp--; stack[sp - 1] /= Math.Abs(stack[sp]) < 1e-12 ? 1e-12 : stack[sp]; break;
+                }
+            }
+            return stack[0];
+        }
+
+        // Recursive descent as before, emitting code instead of evaluating. Like the old
+        // evaluator it stops at the first token it cannot continue with.
+        sealed class Compiler
+        {
+            readonly List<(string kind, string text, double num)> tokens;
+            readonly DerivedFeatures owner;
+            readonly FeatureSchema schema;
+            int i, depth;
+            public readonly List<int> Code = new();
+            public int MaxDepth;
+
+            public Compiler(List<(string, string, double)> tokens, DerivedFeatures owner, FeatureSchema schema)
+            { this.tokens = tokens; this.owner = owner; this.schema = schema; }
+
+            void Push(double v) { Emit(Op.Const, owner.consts.Count); owner.consts.Add(v); }
+
+            void Emit(Op op, int arg = 0)
+            {
+                Code.Add((byte)op | arg << 8);
+                if (op == Op.Const || op == Op.Load) MaxDepth = Math.Max(MaxDepth, ++depth);
+                else if (op != Op.Neg) depth--;
+            }
+
+            void ParsePrimary()
+            {
+                if (i >= tokens.Count) throw new FormatException("unexpected end");
+                var t = tokens[i++];
+                if (t.kind == "num") { Push(t.num); return; }
+                if (t.kind == "id")
+                {
+                    // Ids without a slot yet (unknown, or derived further down) read as 0
+                    int slot = schema.SlotOf(t.text);
+                    if (slot >= 0) Emit(Op.Load, slot); else Push(0);
+                    return;
+                }
+                if (t.text == "(")
+                {
+                    ParseAddSub();
+                    if (i >= tokens.Count || tokens[i++].text != ")") throw new FormatException("missing ')'");
+                    return;
+                }
+                if (t.text == "+") { ParsePrimary(); return; }
+                if (t.text == "-") { ParsePrimary(); Emit(Op.Neg); return; }
+                throw new FormatException($"unexpected '{t.text}'");
+            }
+
+            void ParseMulDiv()
+            {
+                ParsePrimary();
+                while (i < tokens.Count && (tokens[i].text == "*" || tokens[i].text == "/"))
+                {
+                    string op = tokens[i++].text; ParsePrimary();
+                    Emit(op == "*" ? Op.Mul : Op.Div);
+                }
+            }
+
+            public void ParseAddSub()
+            {
+                ParseMulDiv();
+                while (i < tokens.Count && (tokens[i].text == "+" || tokens[i].text == "-"))
+                {
+                    string op = tokens[i++].text; ParseMulDiv();
+                    Emit(op == "+" ? Op.Add : Op.Sub);
+                }
+            }
+        }
+
+        static List<(string kind, string text, double num)> Tokenize(string s)
+        {
+            var list = new List<(string,string,double)>();
+            int n = s.Length, i = 0;
+            while (i < n)
+            {
+                char c = s[i];
+                if (char.IsWhiteSpace(c)) { i++; continue; }
+                if (char.IsDigit(c) || c=='.')
+                {
+                    int j=i; while (j<n && (char.IsDigit(s[j]) || s[j]=='.')) j++;
+                    var sub = s.Substring(i, j-i);
+                    double val = 0; double.TryParse(sub, System.Globalization.NumberStyles.Float, System.Globalization.CultureInfo.InvariantCulture, out val);
+                    list.Add(("num", sub, val)); i=j; continue;
+                }
+                if (char.IsLetter(c) || c=='_' )
+                {
+                    int j=i; while (j<n && (char.IsLetterOrDigit(s[j]) || s[j]=='_' )) j++;
+                    var id = s.Substring(i, j-i);
+                    list.Add(("id", id, 0)); i=j; continue;
+                }
+                // operators and parens
+                list.Add(("sym", c.ToString(), 0)); i++;
+            }
+            return list;
+        }
+    }
+}
@@ -40,12 +40,11 @@ namespace SlimeGrid.Logic
         static bool SetTile(GameState s, V2 p, TileType t, Orientation rot, out string err)
         {
             err = "";
-            ref var cell = ref s.Grid.CellRef(p);
-            bool changed = cell.Type != t || cell.Orientation != rot;
-
-            // Save old cell to allow revert on failed guards
-            var old = cell;
+            // Cells are values: keep the old one to allow revert on failed guards
+            var old = s.Grid.CellRef(p);
+            bool changed = old.Type != t || old.Orientation != rot;
 
+            var cell = old;
             cell.Type = t;
             cell.Orientation = rot;
 
@@ -58,13 +57,13 @@ namespace SlimeGrid.Logic
             var tileMask = TraitsUtil.ResolveTileMask(s, p);
             if (s.EntityAt.ContainsKey(p))
             {
-                if ((tileMask & Traits.StopsEntity) != 0) { err = "Entity present; tile stops entities"; cell = old; s.Grid.SetCell(p, cell); return false; }
-                if ((tileMask & Traits.HoleForEntity) != 0) { err = "Entity present; tile holes entities"; cell = old; s.Grid.SetCell(p, cell); return false; }
+                if ((tileMask & Traits.StopsEntity) != 0) { err = "Entity present; tile stops entities"; s.Grid.SetCell(p, old); return false; }
+                if ((tileMask & Traits.HoleForEntity) != 0) { err = "Entity present; tile holes entities"; s.Grid.SetCell(p, old); return false; }
             }
             if (s.PlayerPos.Equals(p))
             {
-                if ((tileMask & Traits.StopsPlayer) != 0) { err = "Player on tile; tile stops player"; cell = old; s.Grid.SetCell(p, cell); return false; }
-                if ((tileMask & Traits.HoleForPlayer) != 0) { err = "Player on tile; tile holes player"; cell = old; s.Grid.SetCell(p, cell); return false; }
+                if ((tileMask & Traits.StopsPlayer) != 0) { err = "Player on tile; tile stops player"; s.Grid.SetCell(p, old); return false; }
+                if ((tileMask & Traits.HoleForPlayer) != 0) { err = "Player on tile; tile holes player"; s.Grid.SetCell(p, old); return false; }
             }
 
             return changed;
@@ -99,11 +98,13 @@ namespace SlimeGrid.Logic
             {
                 if (s.AttachedEntityId == id) { s.AttachedEntityId = null; s.EntryDir = null; }
                 s.EntityAt.Remove(p); s.EntitiesById.Remove(id);
+                s.Moves?.Vacate(s, p);
+                ButtonCounters.Invalidate(s);
                 return true;
             }
 
             // Reset tile to Floor if not already
-            ref var cell = ref s.Grid.CellRef(p);
+            var cell = s.Grid.CellRef(p);
             if (cell.Type != TileType.Floor)
             {
                 cell.Type = TileType.Floor; cell.Orientation = Orientation.N;
@@ -1,58 +1,70 @@
 // Assets/Code/Logic/Engine.cs
 
+using System;
 using System.Collections.Generic;
 
 namespace SlimeGrid.Logic
 {
     public static class Engine
     {
+        // Per-thread scratch for ResolveState's fall pass
+        [ThreadStatic] static List<int>? fallScratch;
+
         public static StepResult Step(GameState s, Dir moveDir)
         {
             var res = new StepResult();
-            if (s == null || s.Grid == null) return res;
+            if (Step(s, moveDir, ref res))
+            {
+                res.GameOver = s.GameOver;
+                res.Win = s.Win;
+            }
+            return res;
+        }
+
+        // Same step with deltas sent to any sink (NullStepSink in searches).
+        // Returns false when the chosen verb failed and nothing was resolved.
+        public static bool Step<TSink>(GameState s, Dir moveDir, ref TSink sink) where TSink : IStepSink
+        {
+            if (s == null || s.Grid == null) return false;
 
             s.LastMoveDir = moveDir;
 
             var verb = Decisions.Decide(s, moveDir);
-            res.Deltas.Add(new AttemptAction(Actor.Player, verb, moveDir, s.AttachedEntityId));
+            if (sink.Records) sink.Add(new AttemptAction(Actor.Player, verb, moveDir, s.AttachedEntityId));
 
             bool ok = verb switch
             {
-                Verb.Walk => Mechanics.Walk(s, moveDir, res),
-                Verb.PushChain => (s.AttachedEntityId is int ae) && Mechanics.PushChain(s, ae, moveDir, res),
-                Verb.Tumble => (s.AttachedEntityId is int te) && Mechanics.Tumble(s, te, moveDir, res),
-                Verb.Fly => DoFlyFromAttachment(s, moveDir, res),
+                Verb.Walk => Mechanics.Walk(s, moveDir, ref sink),
+                Verb.PushChain => (s.AttachedEntityId is int ae) && Mechanics.PushChain(s, ae, moveDir, ref sink),
+                Verb.Tumble => (s.AttachedEntityId is int te) && Mechanics.Tumble(s, te, moveDir, ref sink),
+                Verb.Fly => Mechanics.Fly(s, moveDir, ref sink),
                 _ => false
             };
-            if (!ok) return res;
+            if (!ok) return false;
 
             // Recompute buttons (global) and announce edges
-            var was = s.AnyButtonPressed;
             s.AnyButtonPressed = ComputeAnyButtonPressed(s);
 
             if (s.AnyButtonPressed != s.LastAnyButtonPressed)
             {
-                res.Deltas.Add(new ButtonStateChanged(s.AnyButtonPressed));
-                res.Deltas.Add(new AnimationCue(s.AnyButtonPressed ? CueType.ButtonPress : CueType.ButtonRelease, null, 0.5f));
-                res.Deltas.Add(new AnimationCue(CueType.ToggleSweep, null, 0.6f));
+                if (sink.Records)
+                {
+                    sink.Add(new ButtonStateChanged(s.AnyButtonPressed));
+                    sink.Add(new AnimationCue(s.AnyButtonPressed ? CueType.ButtonPress : CueType.ButtonRelease, null, 0.5f));
+                    sink.Add(new AnimationCue(CueType.ToggleSweep, null, 0.6f));
+                }
                 s.LastAnyButtonPressed = s.AnyButtonPressed;
             }
 
             // Resolve late effects: attach, falls, win/lose
-            ResolveState(s, res);
-
-            res.GameOver = s.GameOver;
-            res.Win = s.Win;
-            return res;
-        }
-
-        static bool DoFlyFromAttachment(GameState s, Dir moveDir, StepResult outRes)
-        {
-            return Mechanics.Fly(s, moveDir, outRes);
+            ResolveState(s, ref sink);
+            return true;
         }
 
         static bool ComputeAnyButtonPressed(GameState s)
         {
+            if (s.Grid.Compiled.ButtonsStatic) return ButtonCounters.AnyTogglePressed(s);
+
             foreach (var kv in s.EntitiesById)
             {
                 var e = kv.Value;
@@ -66,6 +78,8 @@ namespace SlimeGrid.Logic
 
         static bool AllAllowExitPressed(GameState s)
         {
+            if (s.Grid.Compiled.ButtonsStatic) return ButtonCounters.AllAllowExitPressed(s);
+
             // Scan every cell that is a ButtonAllowExit and ensure it's pressed by an entity with PressesButtons
             for (int y = 0; y < s.Grid.H; y++)
                 for (int x = 0; x < s.Grid.W; x++)
@@ -82,7 +96,7 @@ namespace SlimeGrid.Logic
             return true;
         }
 
-        static void ResolveState(GameState s, StepResult outRes)
+        static void ResolveState<TSink>(GameState s, ref TSink outRes) where TSink : IStepSink
         {
             // Attach if player stopped on an Attachable entity (avoid duplicates)
             if (s.EntityAt.TryGetValue(s.PlayerPos, out var eid))
@@ -94,38 +108,47 @@ namespace SlimeGrid.Logic
                     {
                         s.AttachedEntityId = eid;
                         s.EntryDir = s.LastMoveDir.Opposite();
-                        outRes.Deltas.Add(new SetAttachment(eid, s.EntryDir));
+                        if (outRes.Records) outRes.Add(new SetAttachment(eid, s.EntryDir));
                     }
                 }
             }
 
             // Entities fall
-            List<int> toRemove = null;
+            var toRemove = fallScratch ??= new List<int>();
+            toRemove.Clear();
             foreach (var kv in s.EntitiesById)
             {
                 var e = kv.Value;
                 var tile = TraitsUtil.ResolveTileMask(s, e.Pos);
                 if ((tile & Traits.HoleForEntity) != 0)
                 {
-                    (toRemove ??= new List<int>()).Add(e.Id);
+                    toRemove.Add(e.Id);
                 }
             }
-            if (toRemove != null)
+            if (toRemove.Count > 0)
             {
                 foreach (var id in toRemove)
                 {
                     var pos = s.EntitiesById[id].Pos;
+                    ButtonCounters.Track(s, s.EntitiesById[id], pos, -1);
                     s.EntityAt.Remove(pos);
+                    s.Moves?.Vacate(s, pos);
                     s.EntitiesById.Remove(id);
-                    outRes.Deltas.Add(new DestroyEntity(id, pos, "fallEntity"));
-                    outRes.Deltas.Add(new AnimationCue(CueType.Fall, pos, 0.55f));
+                    if (outRes.Records)
+                    {
+                        outRes.Add(new DestroyEntity(id, pos, "fallEntity"));
+                        outRes.Add(new AnimationCue(CueType.Fall, pos, 0.55f));
+                    }
 
                     if (s.AttachedEntityId == id)
                     {
                         s.GameOver = true;
                         s.AttachedEntityId = null;
-                        outRes.Deltas.Add(new SetGameOver());
-                        outRes.Deltas.Add(new AnimationCue(CueType.GameOverThud, s.PlayerPos, 0.7f));
+                        if (outRes.Records)
+                        {
+                            outRes.Add(new SetGameOver());
+                            outRes.Add(new AnimationCue(CueType.GameOverThud, s.PlayerPos, 0.7f));
+                        }
                         return;
                     }
                 }
@@ -135,8 +158,11 @@ namespace SlimeGrid.Logic
             if (s.AttachedEntityId == null && (TraitsUtil.ResolveTileMask(s, s.PlayerPos) & Traits.HoleForPlayer) != 0)
             {
                 s.GameOver = true;
-                outRes.Deltas.Add(new SetGameOver());
-                outRes.Deltas.Add(new AnimationCue(CueType.GameOverThud, s.PlayerPos, 0.7f));
+                if (outRes.Records)
+                {
+                    outRes.Add(new SetGameOver());
+                    outRes.Add(new AnimationCue(CueType.GameOverThud, s.PlayerPos, 0.7f));
+                }
                 return;
             }
 
@@ -146,8 +172,11 @@ namespace SlimeGrid.Logic
                 && AllAllowExitPressed(s))
             {
                 s.Win = true;
-                outRes.Deltas.Add(new SetWin());
-                outRes.Deltas.Add(new AnimationCue(CueType.WinFanfare, s.PlayerPos, 0.7f));
+                if (outRes.Records)
+                {
+                    outRes.Add(new SetWin());
+                    outRes.Add(new AnimationCue(CueType.WinFanfare, s.PlayerPos, 0.7f));
+                }
             }
         }
     }
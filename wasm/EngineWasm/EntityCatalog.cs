@@ -51,7 +51,8 @@ namespace SlimeGrid.Logic
         // -------- Spawn helper ------------------------------------------------
 
         // Simple id allocator; you can move this to GameState later if you prefer.
-        static int _nextId = 1;
+        // Interlocked: ALD loads and solves levels on several threads at once.
+        static int _nextId = 0;
 
         public static Entity Spawn(GameState s, EntityType type, V2 pos)
         {
@@ -59,7 +60,7 @@ namespace SlimeGrid.Logic
 
             var e = new Entity
             {
-                Id = _nextId++,
+                Id = System.Threading.Interlocked.Increment(ref _nextId),
                 Type = type,
                 Pos = pos,
                 Traits = def.Traits,
@@ -69,6 +70,8 @@ namespace SlimeGrid.Logic
 
             s.EntitiesById[e.Id] = e;
             s.EntityAt[pos] = e.Id;
+            ButtonCounters.Invalidate(s); // callers may still adjust traits
+            s.Moves?.Occupy(s, pos);
             return e;
         }
     }
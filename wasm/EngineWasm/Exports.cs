@@ -174,7 +174,7 @@ public partial class Exports
         cell.Type = tt;
         ApplyRecipeToCell(ref cell, TileTraits.For(tt));
         cell.Toggled = false;
-        s.Grid.CellRef(p) = cell;
+        s.Grid.SetCell(p, cell);
         session.PushUndo(before);
         return JsonSerializer.Serialize(new { ok = true }, J);
     }
@@ -207,6 +207,8 @@ public partial class Exports
         var before = CloneState(s);
         s.EntityAt.Remove(p);
         s.EntitiesById.Remove(id);
+        s.Moves?.Vacate(s, p);
+        ButtonCounters.Invalidate(s);
         if (s.AttachedEntityId == id) { s.AttachedEntityId = null; s.EntryDir = null; }
         session.PushUndo(before);
         return JsonSerializer.Serialize(new { ok = true, id }, J);
@@ -292,7 +294,7 @@ public partial class Exports
         var state = Loader.FromDTO(dto);
         var mask = SlimeGrid.Tools.ALD.InfluenceMask.Compute(state);
         var settings = SlimeGrid.Tools.ALD.Controller.DefaultSettings();
-        bool ok = SlimeGrid.Tools.ALD.ReplaceOperator.TryApply(new System.Random(), settings, state, dto, mask, out var dtoOut);
+        bool ok = SlimeGrid.Tools.ALD.ReplaceOperator.TryApply(new System.Random(), settings, dto, mask, out var dtoOut);
         return Newtonsoft.Json.JsonConvert.SerializeObject(new { ok, level = dtoOut });
     }
 #else
@@ -314,39 +316,79 @@ public partial class Exports
     {
         try
         {
-            var list = Newtonsoft.Json.JsonConvert.DeserializeObject<List<AldEntry>>(entriesJson) ?? new List<AldEntry>();
-            if (list.Count == 0) return System.Text.Json.JsonSerializer.Serialize(new { ok = false, err = "empty" }, J);
+            // JS usually passes the same archive for many draws; reuse its pool and alias table
+            var sel = _selectBase;
+            if (sel == null || !string.Equals(sel.Json, entriesJson, StringComparison.Ordinal) || sel.TopK != topK || sel.Skew != skew)
+            {
+                var list = Newtonsoft.Json.JsonConvert.DeserializeObject<List<AldEntry>>(entriesJson) ?? new List<AldEntry>();
+                if (list.Count == 0) return System.Text.Json.JsonSerializer.Serialize(new { ok = false, err = "empty" }, J);
 
-            // Take topK highest score
-            list.Sort((a, b) => (b.score ?? 0).CompareTo(a.score ?? 0));
-            var pool = new List<AldEntry>();
-            for (int i = 0; i < list.Count && i < Math.Max(1, topK); i++) pool.Add(list[i]);
-            if (pool.Count == 0) return System.Text.Json.JsonSerializer.Serialize(new { ok = false, err = "empty_pool" }, J);
+                // Take topK highest score, without sorting the whole list
+                int k = Math.Max(1, topK);
+                var pool = new List<AldEntry>(Math.Min(k, list.Count));
+                foreach (var e in list)
+                {
+                    double s = e.score ?? 0;
+                    if (pool.Count == k && s <= (pool[k - 1].score ?? 0)) continue;
+                    int at = pool.Count;
+                    while (at > 0 && (pool[at - 1].score ?? 0) < s) at--;
+                    pool.Insert(at, e);
+                    if (pool.Count > k) pool.RemoveAt(k);
+                }
+                if (pool.Count == 0) return System.Text.Json.JsonSerializer.Serialize(new { ok = false, err = "empty_pool" }, J);
 
-            double min = double.PositiveInfinity, max = double.NegativeInfinity;
-            foreach (var e in pool) { var s = e.score ?? 0; if (s < min) min = s; if (s > max) max = s; }
-            double eps = 1e-6;
-            var weights = new double[pool.Count]; double sum = 0;
-            for (int i = 0; i < pool.Count; i++)
-            {
-                double s = pool[i].score ?? 0;
-                double basew = (s - min) + eps; if (basew < eps) basew = eps;
-                double w = skew <= 0 ? 1.0 : Math.Pow(basew, skew);
-                weights[i] = w; sum += w;
+                var scores = new double[pool.Count];
+                for (int i = 0; i < pool.Count; i++) scores[i] = pool[i].score ?? 0;
+                _selectBase = sel = new SelectBaseCache { Json = entriesJson, TopK = topK, Skew = skew, Pool = pool, Table = AliasTable.ForScores(scores, skew) };
             }
-            var rng = new System.Random();
-            double r = rng.NextDouble() * (sum > 0 ? sum : 1.0);
-            for (int i = 0; i < pool.Count; i++)
+            var chosen = sel.Pool[sel.Table.Next(Random.Shared)];
+            return Newtonsoft.Json.JsonConvert.SerializeObject(new { ok = true, level = chosen.level });
+        }
+        catch (Exception ex)
+        {
+            return System.Text.Json.JsonSerializer.Serialize(new { ok = false, err = ex.Message }, J);
+        }
+    }
+
+    static SelectBaseCache? _selectBase;
+
+    // One Controller generation run (mutate -> solve -> insert) from a seed level. Returns a
+    // promise, but without WASM threads the solves still run on the browser thread, so call
+    // it from a worker to keep the page responsive. settingsJson: GeneratorSettings (empty
+    // for Controller.DefaultSettings). timeoutMs > 0 cancels the run; the buckets then hold
+    // what was inserted by that time.
+#if EXPOSE_WASM
+    [JSExport]
+#endif
+    public static async Task<string> ALD_RunOnce(string seedJson, string settingsJson, int candidatesToTry, int timeoutMs)
+    {
+        try
+        {
+            var seed = Newtonsoft.Json.JsonConvert.DeserializeObject<LevelDTO>(seedJson);
+            if (seed == null) return System.Text.Json.JsonSerializer.Serialize(new { ok = false, err = "no_seed" }, J);
+            var settings = string.IsNullOrWhiteSpace(settingsJson)
+                ? Controller.DefaultSettings()
+                : Newtonsoft.Json.JsonConvert.DeserializeObject<GeneratorSettings>(settingsJson) ?? Controller.DefaultSettings();
+            using var cts = timeoutMs > 0 ? new CancellationTokenSource(timeoutMs) : new CancellationTokenSource();
+            var run = await Controller.RunOnceFromDTOAsync(seed, settings, candidatesToTry, cts.Token);
+
+            var buckets = new List<object>();
+            foreach (var b in run.Buckets)
             {
-                r -= weights[i];
-                if (r <= 0)
-                {
-                    var chosen = pool[i];
-                    return Newtonsoft.Json.JsonConvert.SerializeObject(new { ok = true, level = chosen.level });
-                }
+                var entries = new List<object>();
+                foreach (var it in b.Ranked)
+                    entries.Add(new { level = it.dto, score = it.normalizedScore, metrics = FeatureSchema.Base.ToDictionary(it.features) });
+                buckets.Add(new { name = b.Config.name, entries });
             }
-            var last = pool[pool.Count - 1];
-            return Newtonsoft.Json.JsonConvert.SerializeObject(new { ok = true, level = last.level });
+            var c = run.Counters;
+            var counters = new
+            {
+                attempts = c.Attempts, failed = c.Failed, duplicates = c.Duplicates, produced = c.Produced,
+                solved = c.Solved, consumed = c.Consumed, inserted = c.Inserted,
+                producerStalls = c.ProducerStalls, solverStalls = c.SolverStalls,
+                elapsedMs = c.Elapsed.TotalMilliseconds, solvedPerSecond = c.PerSecond(c.Solved)
+            };
+            return Newtonsoft.Json.JsonConvert.SerializeObject(new { ok = true, cancelled = run.Cancelled, buckets, counters });
         }
         catch (Exception ex)
         {
@@ -368,7 +410,7 @@ public partial class Exports
             var ctx = new SlimeGrid.Tools.ALD.AldContext(settings);
             var id = Guid.NewGuid().ToString("N");
             _aldCtx[id] = ctx;
-            return System.Text.Json.JsonSerializer.Serialize(new { ok = true, ctxId = id }, J);
+            return System.Text.Json.JsonSerializer.Serialize(new { ok = true, ctxId = id, derivedErrors = ctx.Derived.Errors }, J);
         }
         catch (Exception ex)
         {
@@ -415,22 +457,21 @@ public partial class Exports
             var buckets = new List<object>();
             foreach (var b in ctx.Buckets)
             {
-                // Copy and sort entries by score (descending) for UI display
-                var sorted = new List<SlimeGrid.Tools.ALD.LevelCandidate>(b.Items);
-                sorted.Sort((a, c) => c.normalizedScore.CompareTo(a.normalizedScore));
-
+                // Entries by score (descending) for UI display
                 var items = new List<object>();
-                foreach (var it in sorted)
+                foreach (var it in b.Ranked)
                 {
                     items.Add(new {
                         level = it.dto,
                         score = it.normalizedScore,
-                        metrics = it.features
+                        metrics = ctx.Schema.ToDictionary(it.features)
                     });
                 }
                 buckets.Add(new { name = b.Config.name, entries = items });
             }
-            return Newtonsoft.Json.JsonConvert.SerializeObject(new { ok = true, buckets });
+            var seen = ctx.SeenSignatures;
+            var dedupe = new { mode = seen.Mode, seen = seen.Count, falsePositiveRate = seen.FalsePositiveRate };
+            return Newtonsoft.Json.JsonConvert.SerializeObject(new { ok = true, buckets, dedupe });
         }
         catch (Exception ex)
         {
@@ -524,6 +565,15 @@ public partial class Exports
         public double? score { get; set; }
         public LevelDTO level { get; set; }
     }
+
+    // Last ALD_SelectBase input and the pool/alias table built from it. Compared ordinally
+    // against the next call's JSON: the same linear pass a hash would take, without collisions.
+    private sealed class SelectBaseCache
+    {
+        public required string Json; public int TopK; public double Skew;
+        public required List<AldEntry> Pool;
+        public required AliasTable Table;
+    }
     // Greedy single-edit ops (always available in this build)
 #if EXPOSE_WASM
     [JSExport]
@@ -642,7 +692,7 @@ public partial class Exports
                 for (int x = 0; x < w; x++)
                 {
                     var p = new V2(x, y);
-                    ref var cell = ref _cur.Grid.CellRef(p);
+                    ref readonly var cell = ref _cur.Grid.CellRef(p);
                     tiles[y * w + x] = (int)cell.Type;
                 }
 
@@ -717,6 +767,9 @@ public partial class Exports
             LastAnyButtonPressed = s.LastAnyButtonPressed,
             GameOver = s.GameOver,
             Win = s.Win,
+            PressedToggleButtons = s.PressedToggleButtons,
+            PressedAllowExitButtons = s.PressedAllowExitButtons,
+            ButtonsVersion = s.ButtonsVersion,
         };
         foreach (var kv in s.EntitiesById)
         {
@@ -0,0 +1,45 @@
+using System.Collections.Generic;
+
+namespace SlimeGrid.Tools.ALD
+{
+    // Feature ids -> slots of the float[] feature vectors. The base features come first in
+    // Heuristics.BaseFeatures order; a context appends the derived ids it compiles. Scoring
+    // and derived expressions work on slots; ids only come back at the JSON boundary.
+    public sealed class FeatureSchema
+    {
+        public static readonly FeatureSchema Base = new FeatureSchema(Heuristics.BaseFeatures);
+
+        readonly List<string> ids;
+        readonly Dictionary<string, int> slots;
+
+        FeatureSchema(IEnumerable<string> ids)
+        {
+            this.ids = new List<string>();
+            slots = new Dictionary<string, int>();
+            foreach (var id in ids) Add(id);
+        }
+
+        public int Count => ids.Count;
+        public string IdOf(int slot) => ids[slot];
+        public int SlotOf(string id) => id != null && slots.TryGetValue(id, out int s) ? s : -1;
+
+        // Slot of `id`, appended when new
+        public int Add(string id)
+        {
+            if (slots.TryGetValue(id, out int s)) return s;
+            slots[id] = s = ids.Count;
+            ids.Add(id);
+            return s;
+        }
+
+        public FeatureSchema Extend() => new FeatureSchema(ids);
+
+        public Dictionary<string, float> ToDictionary(float[] features)
+        {
+            var d = new Dictionary<string, float>(ids.Count);
+            if (features == null) return d;
+            for (int i = 0; i < ids.Count && i < features.Length; i++) d[ids[i]] = features[i];
+            return d;
+        }
+    }
+}
@@ -0,0 +1,213 @@
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Threading;
+using System.Threading.Channels;
+using System.Threading.Tasks;
+using SlimeGrid.Logic;
+using SlimeGrid.Tools.Solver;
+
+namespace SlimeGrid.Tools.ALD
+{
+    // Stage counters of a generation run. Updated with Interlocked while it runs, so another
+    // thread can poll them for throughput; the stalls count writes that found the next stage's
+    // queue full (backpressure).
+    public sealed class PipelineCounters
+    {
+        internal long attempts, failed, duplicates, produced, producerStalls;
+        internal long solved, solverStalls;
+        internal long consumed, inserted;
+        internal readonly Stopwatch clock = new();
+
+        public long Attempts => Interlocked.Read(ref attempts);       // mutations tried
+        public long Failed => Interlocked.Read(ref failed);           // mutations that did not apply
+        public long Duplicates => Interlocked.Read(ref duplicates);   // signatures seen already
+        public long Produced => Interlocked.Read(ref produced);       // queued for the solvers
+        public long ProducerStalls => Interlocked.Read(ref producerStalls);
+        public long Solved => Interlocked.Read(ref solved);
+        public long SolverStalls => Interlocked.Read(ref solverStalls);
+        public long Consumed => Interlocked.Read(ref consumed);       // scored against the buckets
+        public long Inserted => Interlocked.Read(ref inserted);       // bucket inserts, one per bucket kept in
+        public TimeSpan Elapsed => clock.Elapsed;
+
+        public double PerSecond(long count) => Elapsed.TotalSeconds > 0 ? count / Elapsed.TotalSeconds : 0;
+    }
+
+    public sealed class GenerationRun
+    {
+        public required List<Bucket> Buckets;
+        public required PipelineCounters Counters;
+        public bool Cancelled; // Buckets hold what was inserted before cancellation
+    }
+
+    // Mutate -> solve -> insert as a streaming pipeline over bounded channels:
+    //   producers (GeneratorSettings.producers) mutate the seed and drop seen signatures,
+    //   solver workers (GeneratorSettings.parallelism) analyze and compute features,
+    //   one consumer scores and inserts, so buckets stay single-threaded.
+    // Full queues make the earlier stage wait. Cancelling stops producers and solvers (a solve
+    // in progress finishes and is still handed on), the consumer drains what was already
+    // solved, and every stage has ended before RunAsync returns. A failing stage cancels the
+    // others and its exception is rethrown. All solving, the seed's included, runs in the
+    // stages: with threads the caller's thread stays free, but a single-threaded browser build
+    // (no WASM threads) runs the stages on its one thread and still stalls while they solve.
+    public static class GenerationPipeline
+    {
+        readonly struct Mutant
+        {
+            public readonly LevelDTO Dto;
+            public readonly GameState State;
+            public readonly ulong Sig;
+            public Mutant(LevelDTO dto, GameState state, ulong sig) { Dto = dto; State = state; Sig = sig; }
+        }
+
+        public static async Task<GenerationRun> RunAsync(LevelDTO seedDto, GeneratorSettings settings, int candidatesToTry, CancellationToken ct = default)
+        {
+            var counters = new PipelineCounters();
+            counters.clock.Start();
+            var seed = Loader.FromDTO(seedDto);
+            var mask = InfluenceMask.Compute(seed);
+            var seedSig = InfluenceMask.CanonicalSignature(seed, mask);
+
+            var buckets = new List<Bucket>();
+            foreach (var bc in settings.buckets) buckets.Add(new Bucket(bc));
+            var seen = new HashSet<ulong> { seedSig };
+            var rng = new Random();
+            var dedupe = new DedupeSettings();
+
+            // Candidates keep their raw score while the run streams in; at the end every bucket
+            // is normalized against the raw range of what it scored, seed included
+            var range = new (float min, float max)[buckets.Count];
+            for (int i = 0; i < range.Length; i++) range[i] = (float.PositiveInfinity, float.NegativeInfinity);
+
+            var cfg = new SolverConfig();
+            var seedLevel = LevelModel.FromDTO(seedDto); // read-only below; TryApply mutates a clone
+            int producers = Math.Max(1, settings.producers);
+            int solvers = Math.Max(1, settings.parallelism);
+            int capacity = settings.queueCapacity > 0 ? settings.queueCapacity : 2 * solvers;
+
+            var mutants = Channel.CreateBounded<Mutant>(new BoundedChannelOptions(capacity) { FullMode = BoundedChannelFullMode.Wait, SingleWriter = producers == 1 });
+            var solvedQueue = Channel.CreateBounded<LevelCandidate>(new BoundedChannelOptions(capacity) { FullMode = BoundedChannelFullMode.Wait, SingleReader = true });
+            // `failed` only fires when a stage throws; `stop` also on the caller's cancellation
+            using var failed = new CancellationTokenSource();
+            using var stop = CancellationTokenSource.CreateLinkedTokenSource(ct, failed.Token);
+
+            async Task Produce(Random prng)
+            {
+                while (!stop.IsCancellationRequested)
+                {
+                    if (Interlocked.Increment(ref counters.attempts) > candidatesToTry) { Interlocked.Decrement(ref counters.attempts); break; }
+                    if (!ReplaceOperator.TryApply(prng, settings, seedLevel, mask, out var level)) { Interlocked.Increment(ref counters.failed); continue; }
+                    var mutated = level.ToState();
+                    var sig = InfluenceMask.CanonicalSignature(mutated, mask);
+                    bool added;
+                    lock (seen) added = seen.Add(sig);
+                    if (!added) { Interlocked.Increment(ref counters.duplicates); continue; }
+
+                    var m = new Mutant(level.ToDTO(), mutated, sig);
+                    if (!mutants.Writer.TryWrite(m))
+                    {
+                        Interlocked.Increment(ref counters.producerStalls);
+                        await mutants.Writer.WriteAsync(m, stop.Token).ConfigureAwait(false);
+                    }
+                    Interlocked.Increment(ref counters.produced);
+                }
+            }
+
+            async Task Solve()
+            {
+                await foreach (var m in mutants.Reader.ReadAllAsync(stop.Token).ConfigureAwait(false))
+                {
+                    var report = BruteForceSolver.Analyze(m.State, cfg);
+                    var cand = new LevelCandidate { dto = m.Dto, reachableHash = m.Sig, report = report, state = m.State };
+                    cand.features = Heuristics.ComputeFeatures(report);
+                    if (!solvedQueue.Writer.TryWrite(cand))
+                    {
+                        // Finished solves reach the consumer after a stop; only a failure drops them
+                        Interlocked.Increment(ref counters.solverStalls);
+                        await solvedQueue.Writer.WriteAsync(cand, failed.Token).ConfigureAwait(false);
+                    }
+                    Interlocked.Increment(ref counters.solved);
+                }
+            }
+
+            // The consumer owns the buckets, so it scores the seed before anything else
+            void EvaluateSeed()
+            {
+                var seedReport = BruteForceSolver.Analyze(seed, new SolverConfig());
+                var seedFeatures = Heuristics.ComputeFeatures(seedReport);
+                LayoutFeatures? seedLayout = null;
+                for (int i = 0; i < buckets.Count; i++)
+                {
+                    var b = buckets[i];
+                    var (raw, reject) = b.Scorer.Score(seedFeatures, settings.accept_capped_weight);
+                    if (reject) continue;
+                    range[i] = (raw, raw);
+                    var seedCand = new LevelCandidate { dto = seedDto, reachableHash = seedSig, report = seedReport, features = seedFeatures, rawScore = raw, normalizedScore = raw, state = seed };
+                    if (seedLayout != null) seedCand.layout = seedLayout; else seedLayout = Similarity.FeaturesOf(seedCand);
+                    if (b.PassSimilarity(seedCand, dedupe)) b.TryInsert(seedCand);
+                }
+            }
+
+            async Task Consume()
+            {
+                EvaluateSeed();
+                // Not cancelled: whatever was solved before a stop still gets inserted
+                await foreach (var solved in solvedQueue.Reader.ReadAllAsync().ConfigureAwait(false))
+                {
+                    LayoutFeatures? layout = null;
+                    for (int i = 0; i < buckets.Count; i++)
+                    {
+                        var b = buckets[i];
+                        var (raw, reject) = b.Scorer.Score(solved.features, settings.accept_capped_weight);
+                        if (reject) continue;
+                        range[i] = (Math.Min(range[i].min, raw), Math.Max(range[i].max, raw));
+                        var cand = new LevelCandidate { dto = solved.dto, reachableHash = solved.reachableHash, report = solved.report, features = solved.features, rawScore = raw, normalizedScore = raw, state = solved.state };
+                        if (layout != null) cand.layout = layout; else layout = Similarity.FeaturesOf(cand);
+                        if (b.PassSimilarity(cand, dedupe) && b.TryInsert(cand)) Interlocked.Increment(ref counters.inserted);
+                    }
+                    Interlocked.Increment(ref counters.consumed);
+                }
+            }
+
+            // Each stage completes the next one's queue when its last task ends
+            var produce = new Task[producers];
+            for (int i = 0; i < producers; i++) { var prng = new Random(rng.Next()); produce[i] = Stage(() => Produce(prng), stop, failed); }
+            var solve = new Task[solvers];
+            for (int i = 0; i < solvers; i++) solve[i] = Stage(Solve, stop, failed);
+            var consume = Stage(Consume, stop, failed);
+            var produced = CompleteAfter(produce, mutants.Writer);
+            var solvedAll = CompleteAfter(solve, solvedQueue.Writer);
+            try { await Task.WhenAll(produced, solvedAll, consume).ConfigureAwait(false); }
+            finally { counters.clock.Stop(); }
+
+            for (int i = 0; i < buckets.Count; i++)
+            {
+                var (min, max) = range[i];
+                if (min <= max) buckets[i].Rescore(c => Normalize(c.rawScore, min, max));
+            }
+            return new GenerationRun { Buckets = buckets, Counters = counters, Cancelled = ct.IsCancellationRequested };
+        }
+
+        // Runs a stage on the thread pool. Stops from cancellation end it quietly; a failure
+        // cancels the other stages so nothing waits on a queue nobody reads.
+        static Task Stage(Func<Task> body, CancellationTokenSource stop, CancellationTokenSource failed) => Task.Run(async () =>
+        {
+            try { await body().ConfigureAwait(false); }
+            catch (OperationCanceledException) when (stop.IsCancellationRequested) { }
+            catch { failed.Cancel(); throw; }
+        });
+
+        static async Task CompleteAfter<T>(Task[] stage, ChannelWriter<T> next)
+        {
+            try { await Task.WhenAll(stage).ConfigureAwait(false); next.TryComplete(); }
+            catch (Exception ex) { next.TryComplete(ex); throw; }
+        }
+
+        static float Normalize(float raw, float min, float max)
+        {
+            if (max <= min + 1e-5f) return 0f;
+            float t = (raw - min) / (max - min);
+            return Math.Max(-1f, Math.Min(1f, 2f * t - 1f));
+        }
+    }
+}
@@ -1,6 +1,8 @@
 using System;
 using System.Collections.Generic;
 using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
 using SlimeGrid.Logic;
 using SlimeGrid.Tools.Solver;
 
@@ -16,6 +18,7 @@ namespace SlimeGrid.Tools.ALD
             public bool movePlayer { get; set; } = false; // allow relocating PlayerSpawn
             public int maxDepth { get; set; } = 100;
             public int maxNodes { get; set; } = 200000;
+            public int parallelism { get; set; } = 1; // candidate solves in flight; ALD already runs candidates in parallel
         }
 
         public sealed class RemoveOneOptions
@@ -42,11 +45,30 @@ namespace SlimeGrid.Tools.ALD
 
         public static GreedyResult PlaceOne(LevelDTO seedDto, PlaceOneOptions opts)
         {
-            var seed = Loader.FromDTO(seedDto);
-            var cfg = new SolverConfig { DepthCap = opts.maxDepth, NodesCap = opts.maxNodes };
+            var (res, level) = PlaceOne(LevelModel.FromDTO(seedDto), opts);
+            if (level != null) res.level = level.ToDTO();
+            return res;
+        }
+
+        // One single-cell edit; Outside = the seed's influence mask shows it cannot change play
+        readonly struct Candidate
+        {
+            public readonly int X, Y;
+            public readonly TileType? Tile;
+            public readonly EntityType? Entity;
+            public readonly bool Outside;
+            public Candidate(int x, int y, TileType? tile, EntityType? entity, bool outside)
+            { X = x; Y = y; Tile = tile; Entity = entity; Outside = outside; }
+        }
+
+        struct Score { public bool Ok; public int Fastest, DeadEnds, Solutions; }
+
+        public static (GreedyResult result, LevelModel? level) PlaceOne(LevelModel seedLevel, PlaceOneOptions opts)
+        {
+            var seed = seedLevel.ToState();
 
             var W = seed.Grid.W; var H = seed.Grid.H;
-            string bestTile = null, bestEntity = null, bestOrient = null;
+            string? bestTile = null, bestEntity = null, bestOrient = null;
             int bestX = -1, bestY = -1, bestFast = -1, bestDead = -1, bestSols = int.MaxValue;
 
             // Helper to compare candidate hardness
@@ -62,7 +84,17 @@ namespace SlimeGrid.Tools.ALD
             var tilesAllowed = new HashSet<string>((opts.tilesPlace ?? new()).Select(n => (n ?? string.Empty).Trim()), StringComparer.OrdinalIgnoreCase);
             var entsAllowed = new HashSet<string>((opts.entitiesPlace ?? new()).Select(n => (n ?? string.Empty).Trim()), StringComparer.OrdinalIgnoreCase);
 
-            // Evaluate tile placements
+            // Cells outside the mask are neither the player's wall component nor next to it: nothing
+            // ever moves onto them. An edit there is inert unless it changes the allow-exit button
+            // count or sits under / puts an entity on a button (the pressed counts are global).
+            // Legacy per-cell trait overrides are not modelled here, so no pruning with them.
+            var mask = seedLevel.HasLegacyTiles ? null : InfluenceMask.Compute(seed);
+            bool Inert(int x, int y) => mask != null && !mask[x, y] && !seed.EntityAt.ContainsKey(new V2(x, y));
+
+            // Candidates in scan order (tiles, then entities); ties keep the earliest
+            var cands = new List<Candidate>();
+
+            // Tile placements
             if (tilesAllowed.Count > 0)
             {
                 for (int y = 0; y < H; y++)
@@ -72,25 +104,14 @@ namespace SlimeGrid.Tools.ALD
                     {
                         if (!Enum.TryParse<TileType>(name, ignoreCase: true, out var tt)) continue;
                         // Skip if unchanged
-                        if (seed.Grid.CellRef(new V2(x, y)).Type == tt) continue;
-                        var testDto = CloneDTO(seedDto);
-                        EnsureGridInitialized(testDto);
-                        testDto.tileGrid[y][x] = tt.ToString();
-                        var report = BruteForceSolver.AnalyzeBfs(Loader.FromDTO(testDto), cfg);
-                        if (report.topSolutions == null || report.topSolutions.Count == 0) continue;
-                        int fastest = report.topSolutions[0].length;
-                        int deads = report.deadEndsCount;
-                        int sols = report.solutionsFilteredCount;
-                        if (Better(fastest, deads, sols))
-                        {
-                            bestX = x; bestY = y; bestTile = tt.ToString(); bestEntity = null; bestOrient = null;
-                            bestFast = fastest; bestDead = deads; bestSols = sols;
-                        }
+                        if (seedLevel[x, y] == tt) continue;
+                        bool outside = Inert(x, y) && tt != TileType.ButtonAllowExit && seedLevel[x, y] != TileType.ButtonAllowExit;
+                        cands.Add(new Candidate(x, y, tt, null, outside));
                     }
                 }
             }
 
-            // Evaluate entity placements
+            // Entity placements
             if (entsAllowed.Count > 0)
             {
                 for (int y = 0; y < H; y++)
@@ -99,106 +120,150 @@ namespace SlimeGrid.Tools.ALD
                     foreach (var name in entsAllowed)
                     {
                         if (!Enum.TryParse<EntityType>(name, ignoreCase: true, out var et)) continue;
+                        var pos = new V2(x, y);
                         if (et == EntityType.PlayerSpawn)
                         {
                             if (!opts.movePlayer) continue;
-                            // Only place player on tiles acceptable for player
-                            var pos = new V2(x, y);
                             // Do not place player on top of an existing entity
                             if (seed.EntityAt.ContainsKey(pos)) continue;
+                            // Only place player on tiles acceptable for player
                             var maskp = TraitsUtil.ResolveTileMask(seed, pos);
                             if ((maskp & Traits.StopsPlayer) != 0) continue;
                             if ((maskp & Traits.HoleForPlayer) != 0) continue;
-                            var testDto = CloneDTO(seedDto);
-                            var list = new List<EntityDTO>(testDto.entities ?? new List<EntityDTO>());
-                            list.RemoveAll(e => e != null && e.type == EntityType.PlayerSpawn);
-                            list.Add(new EntityDTO { type = EntityType.PlayerSpawn, x = x, y = y });
-                            testDto.entities = list;
-                            var report = BruteForceSolver.AnalyzeBfs(Loader.FromDTO(testDto), cfg);
-                            if (report.topSolutions == null || report.topSolutions.Count == 0) continue;
-                            int fastest = report.topSolutions[0].length;
-                            int deads = report.deadEndsCount;
-                            int sols = report.solutionsFilteredCount;
-                            if (Better(fastest, deads, sols))
-                            {
-                                bestX = x; bestY = y; bestTile = null; bestEntity = et.ToString(); bestOrient = null;
-                                bestFast = fastest; bestDead = deads; bestSols = sols;
-                            }
+                            cands.Add(new Candidate(x, y, null, et, false));
                             continue;
                         }
                         // For non-spawn entities, ensure cell is free and tile supports entities
-                        var cell = seed.Grid.CellRef(new V2(x, y));
-                        var traits = cell.ActiveMask;
-                        bool blocksBox = (traits & (Traits.StopsEntity | Traits.HoleForEntity)) != 0;
+                        ref readonly var cell = ref seed.Grid.CellRef(pos);
+                        bool blocksBox = (cell.ActiveMask & (Traits.StopsEntity | Traits.HoleForEntity)) != 0;
                         if (blocksBox) continue;
-                        if (seed.EntityAt.ContainsKey(new V2(x, y))) continue;
-
-                        var testDto2 = CloneDTO(seedDto);
-                        var list2 = new List<EntityDTO>(testDto2.entities ?? new List<EntityDTO>());
-                        var eDto = new EntityDTO { type = et, x = x, y = y };
-                        list2.Add(eDto);
-                        testDto2.entities = list2;
-                        var report2 = BruteForceSolver.AnalyzeBfs(Loader.FromDTO(testDto2), cfg);
-                        if (report2.topSolutions == null || report2.topSolutions.Count == 0) continue;
-                        int fastest2 = report2.topSolutions[0].length;
-                        int deads2 = report2.deadEndsCount;
-                        int sols2 = report2.solutionsFilteredCount;
-                        if (Better(fastest2, deads2, sols2))
-                        {
-                            bestX = x; bestY = y; bestTile = null; bestEntity = et.ToString(); bestOrient = null;
-                            bestFast = fastest2; bestDead = deads2; bestSols = sols2;
-                        }
+                        if (seed.EntityAt.ContainsKey(pos)) continue;
+                        const Traits buttons = Traits.ButtonToggle | Traits.ButtonAllowExit;
+                        bool outside = Inert(x, y) && !cell.InactiveMask.HasValue && (cell.ActiveMask & buttons) == 0;
+                        cands.Add(new Candidate(x, y, null, et, outside));
                     }
                 }
             }
 
-            if (bestX < 0)
+            // Inert edits all score like the seed itself, so the seed is solved once, for the first
+            // of them; the later ones can only tie with it and never get picked.
+            var scores = new Score[cands.Count];
+            var todo = new List<int>(cands.Count);
+            int firstInert = -1;
+            bool anyTile = false;
+            for (int i = 0; i < cands.Count; i++)
             {
-                return new GreedyResult { ok = false, err = "no_improving_candidate" };
+                anyTile |= cands[i].Tile.HasValue;
+                if (!cands[i].Outside) todo.Add(i);
+                else if (firstInert < 0) firstInert = i;
             }
 
-            var outDto = CloneDTO(seedDto);
-            if (bestTile != null)
+            // Branch and bound: the longest fastest solution seen so far. A candidate that turns
+            // out to solve faster can never win, so its solve stops at that first short solution.
+            int bound = 0;
+            void Keep(int i, SolverReport report)
             {
-                EnsureGridInitialized(outDto);
-                outDto.tileGrid[bestY][bestX] = bestTile;
+                if (report.caps.boundHit || report.topSolutions == null || report.topSolutions.Count == 0) return;
+                int fastest = report.topSolutions[0].length;
+                scores[i] = new Score { Ok = true, Fastest = fastest, DeadEnds = report.deadEndsCount, Solutions = report.solutionsFilteredCount };
+                for (int b = Volatile.Read(ref bound); fastest > b; b = Volatile.Read(ref bound))
+                    if (Interlocked.CompareExchange(ref bound, fastest, b) == b) break;
             }
-            else if (bestEntity != null)
+
+            // Tile edits keep the seed's entities and spawn, so they re-solve from the seed's
+            // explored graph and only step what can read the edited cell.
+            SolveGraph? seedGraph = null;
+            if (anyTile || firstInert >= 0)
             {
-                var list = new List<EntityDTO>(outDto.entities ?? new List<EntityDTO>());
-                if (string.Equals(bestEntity, EntityType.PlayerSpawn.ToString(), StringComparison.OrdinalIgnoreCase))
-                {
-                    list.RemoveAll(e => e != null && e.type == EntityType.PlayerSpawn);
-                    list.Add(new EntityDTO { type = EntityType.PlayerSpawn, x = bestX, y = bestY });
-                }
-                else
+                var seedReport = BruteForceSolver.AnalyzeBfs(seed, new SolverConfig { DepthCap = opts.maxDepth, NodesCap = opts.maxNodes }, out seedGraph);
+                if (firstInert >= 0) { todo.Add(firstInert); Keep(firstInert, seedReport); }
+            }
+
+            // Spawn moves keep tiles and entities: one enumeration over all their starts, then
+            // each spawn's report is read off that graph instead of searched on its own.
+            var spawnStates = new GameState[cands.Count];
+            var spawnStarts = new List<GameState>();
+            foreach (var i in todo)
+                if (cands[i].Entity == EntityType.PlayerSpawn)
                 {
-                    if (Enum.TryParse<EntityType>(bestEntity, true, out var etype))
-                    {
-                        list.Add(new EntityDTO { type = etype, x = bestX, y = bestY });
-                    }
+                    var level = seedLevel.Clone();
+                    level.AddEntity(EntityType.PlayerSpawn, cands[i].X, cands[i].Y);
+                    spawnStarts.Add(spawnStates[i] = level.ToState());
                 }
-                outDto.entities = list;
+            var spawnGraph = spawnStarts.Count > 1
+                ? BruteForceSolver.ExploreBfs(spawnStarts, new SolverConfig { DepthCap = opts.maxDepth, NodesCap = opts.maxNodes })
+                : null;
+
+            void Evaluate(int i)
+            {
+                var c = cands[i];
+                if (c.Outside) return; // scored with the seed
+                var cfg = new SolverConfig { DepthCap = opts.maxDepth, NodesCap = opts.maxNodes, AbortBelowLength = Volatile.Read(ref bound) };
+                if (spawnStates[i] != null) { Keep(i, BruteForceSolver.AnalyzeBfs(spawnStates[i], cfg, spawnGraph)); return; }
+                var level = seedLevel.Clone();
+                if (c.Tile.HasValue) level[c.X, c.Y] = c.Tile.Value;
+                else if (c.Entity.HasValue) level.AddEntity(c.Entity.Value, c.X, c.Y);
+                Keep(i, c.Tile.HasValue
+                    ? BruteForceSolver.AnalyzeBfs(level.ToState(), cfg, seedGraph)
+                    : BruteForceSolver.AnalyzeBfs(level.ToState(), cfg));
+            }
+
+            if (opts.parallelism > 1)
+                Parallel.For(0, todo.Count, new ParallelOptions { MaxDegreeOfParallelism = opts.parallelism }, k => Evaluate(todo[k]));
+            else
+                foreach (var i in todo) Evaluate(i);
+
+            // Reduce in scan order so the pick matches a sequential scan
+            todo.Sort();
+            foreach (var i in todo)
+            {
+                var sc = scores[i];
+                if (!sc.Ok || !Better(sc.Fastest, sc.DeadEnds, sc.Solutions)) continue;
+                var c = cands[i];
+                bestX = c.X; bestY = c.Y; bestOrient = null;
+                bestTile = c.Tile?.ToString(); bestEntity = c.Entity?.ToString();
+                bestFast = sc.Fastest; bestDead = sc.DeadEnds; bestSols = sc.Solutions;
+            }
+
+            if (bestX < 0)
+            {
+                return (new GreedyResult { ok = false, err = "no_improving_candidate" }, null);
+            }
+
+            var outLevel = seedLevel.Clone();
+            if (bestTile != null)
+            {
+                outLevel[bestX, bestY] = Enum.Parse<TileType>(bestTile);
+            }
+            else if (bestEntity != null && Enum.TryParse<EntityType>(bestEntity, true, out var etype))
+            {
+                outLevel.AddEntity(etype, bestX, bestY);
             }
 
-            return new GreedyResult
+            return (new GreedyResult
             {
                 ok = true,
-                level = outDto,
                 x = bestX, y = bestY,
                 tile = bestTile, entity = bestEntity, orientation = bestOrient,
                 fastest = bestFast, deadEnds = bestDead, solutions = bestSols
-            };
+            }, outLevel);
         }
 
         public static GreedyResult RemoveOne(LevelDTO seedDto, RemoveOneOptions opts)
         {
-            var seed = Loader.FromDTO(seedDto);
+            var (res, level) = RemoveOne(LevelModel.FromDTO(seedDto), opts);
+            if (level != null) res.level = level.ToDTO();
+            return res;
+        }
+
+        public static (GreedyResult result, LevelModel? level) RemoveOne(LevelModel seedLevel, RemoveOneOptions opts)
+        {
+            var seed = seedLevel.ToState();
             var cfg = new SolverConfig { DepthCap = opts.maxDepth, NodesCap = opts.maxNodes };
 
             var baseRep = BruteForceSolver.AnalyzeBfs(seed, cfg);
             if (baseRep.topSolutions == null || baseRep.topSolutions.Count == 0)
-                return new GreedyResult { ok = false, err = "unsolvable_base" };
+                return (new GreedyResult { ok = false, err = "unsolvable_base" }, null);
             int baseFast = baseRep.topSolutions[0].length;
             int baseDead = baseRep.deadEndsCount;
             int baseSols = baseRep.solutionsFilteredCount;
@@ -214,21 +279,18 @@ namespace SlimeGrid.Tools.ALD
             int bestIdx = -1, bestFast = -1, bestDead = -1, bestSols = int.MaxValue;
             string bestEnt = null;
 
-            var stateEntities = seedDto.entities ?? new List<EntityDTO>();
+            var stateEntities = seedLevel.Entities;
             for (int i = 0; i < stateEntities.Count; i++)
             {
                 var e = stateEntities[i];
-                if (e == null) continue;
                 var typeName = e.type.ToString();
                 if (allowed.Count > 0 && !allowed.Contains(typeName)) continue;
                 // do not remove PlayerSpawn here; handled by movePlayer in PlaceOne
                 if (e.type == EntityType.PlayerSpawn) continue;
 
-                var testDto = CloneDTO(seedDto);
-                var list = new List<EntityDTO>(testDto.entities ?? new List<EntityDTO>());
-                if (i >= 0 && i < list.Count) list.RemoveAt(i);
-                testDto.entities = list;
-                var rep = BruteForceSolver.AnalyzeBfs(Loader.FromDTO(testDto), cfg);
+                var test = seedLevel.Clone();
+                test.Entities.RemoveAt(i);
+                var rep = BruteForceSolver.AnalyzeBfs(test.ToState(), cfg);
                 if (rep.topSolutions == null || rep.topSolutions.Count == 0) continue;
                 int f = rep.topSolutions[0].length;
                 int d = rep.deadEndsCount;
@@ -237,37 +299,16 @@ namespace SlimeGrid.Tools.ALD
             }
 
             if (bestIdx < 0)
-                return new GreedyResult { ok = false, err = "no_improving_candidate" };
+                return (new GreedyResult { ok = false, err = "no_improving_candidate" }, null);
 
-            var outDto = CloneDTO(seedDto);
-            var outList = new List<EntityDTO>(outDto.entities ?? new List<EntityDTO>());
-            outList.RemoveAt(bestIdx);
-            outDto.entities = outList;
-            return new GreedyResult
+            var outLevel = seedLevel.Clone();
+            outLevel.Entities.RemoveAt(bestIdx);
+            return (new GreedyResult
             {
                 ok = true,
-                level = outDto,
                 entity = bestEnt,
                 fastest = bestFast, deadEnds = bestDead, solutions = bestSols
-            };
-        }
-
-        // Utilities ---------------------------------------------------------
-        private static LevelDTO CloneDTO(LevelDTO src)
-        {
-            var json = Newtonsoft.Json.JsonConvert.SerializeObject(src);
-            return Newtonsoft.Json.JsonConvert.DeserializeObject<LevelDTO>(json);
-        }
-
-        private static void EnsureGridInitialized(LevelDTO dto)
-        {
-            if (dto.tileGrid != null && dto.tileGrid.Length > 0) return;
-            dto.tileGrid = new string[dto.height][];
-            for (int y = 0; y < dto.height; y++)
-            {
-                dto.tileGrid[y] = new string[dto.width];
-                for (int x = 0; x < dto.width; x++) dto.tileGrid[y][x] = TileType.Floor.ToString();
-            }
+            }, outLevel);
         }
     }
 }
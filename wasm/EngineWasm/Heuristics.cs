@@ -1,119 +1,70 @@
 using System;
-using System.Collections.Generic;
 using SlimeGrid.Tools.Solver;
 
 namespace SlimeGrid.Tools.ALD
 {
     public static class Heuristics
     {
-        public static Dictionary<string, float> ComputeFeatures(SolverReport report)
+        // Base features, in slot order (FeatureSchema.Base)
+        public static readonly string[] BaseFeatures =
         {
-            var f = new Dictionary<string, float>();
-            f["solutionLength"] = report.topSolutions.Count > 0 ? report.topSolutions[0].length : 0;
-            f["solutionsFilteredCount"] = report.solutionsFilteredCount;
-            f["solutionsTotalCount"] = report.solutionsTotalCount;
-            f["deadEndsCount"] = report.deadEndsCount;
-            f["deadEndsAverageDepth"] = (float)report.deadEndsAverageDepth;
-            f["nodesExplored"] = report.nodesExplored;
-            f["maxDepthReached"] = report.maxDepthReached;
-            f["deadEndsNearTop1Count"] = report.deadEndsNearTop1Count;
-            f["deadEndsNearTop3Count"] = report.deadEndsNearTop3Count;
-            // Move analysis features (top solutions)
-            f["stepsInBoxTop1"] = report.stepsInBoxTop1;
-            f["stepsFreeTop1"] = report.stepsFreeTop1;
-            f["dedupMovesLenTop1"] = report.dedupMovesLenTop1;
-            f["stepsInBoxTop3Avg"] = (float)report.stepsInBoxTop3Avg;
-            f["stepsFreeTop3Avg"] = (float)report.stepsFreeTop3Avg;
-            f["dedupMovesLenTop3Avg"] = (float)report.dedupMovesLenTop3Avg;
-            f["precheck.hasExitInComponent"] = report.solvedTag == "false" && report.nodesExplored == 0 ? 0 : 1;
-            f["capped"] = report.solvedTag == "capped" ? 1 : 0;
-            return f;
-        }
+            "solutionLength", "solutionsFilteredCount", "solutionsTotalCount", "deadEndsCount",
+            "deadEndsAverageDepth", "nodesExplored", "maxDepthReached", "deadEndsNearTop1Count",
+            "deadEndsNearTop3Count", "stepsInBoxTop1", "stepsFreeTop1", "dedupMovesLenTop1",
+            "stepsInBoxTop3Avg", "stepsFreeTop3Avg", "dedupMovesLenTop3Avg",
+            "precheck.hasExitInComponent", "capped",
+        };
 
-        // Evaluate derived features from expressions over base features
-        public static void ApplyDerivedFeatures(Dictionary<string, float> f, IEnumerable<SlimeGrid.Tools.ALD.DerivedFeatureConfig> derived)
+        // Vector over `schema` (FeatureSchema.Base when null) with the base slots filled; derived
+        // slots stay 0 until DerivedFeatures.Apply.
+        public static float[] ComputeFeatures(SolverReport report, FeatureSchema? schema = null)
         {
-            if (derived == null) return;
-            foreach (var d in derived)
-            {
-                if (string.IsNullOrWhiteSpace(d?.id) || string.IsNullOrWhiteSpace(d.expr)) continue;
-                try { f[d.id] = (float)EvalExpr(d.expr, f); }
-                catch { /* ignore invalid derived feature */ }
-            }
+            var f = new float[(schema ?? FeatureSchema.Base).Count];
+            int k = 0;
+            f[k++] = report.topSolutions.Count > 0 ? report.topSolutions[0].length : 0;
+            f[k++] = report.solutionsFilteredCount;
+            f[k++] = report.solutionsTotalCount;
+            f[k++] = report.deadEndsCount;
+            f[k++] = (float)report.deadEndsAverageDepth;
+            f[k++] = report.nodesExplored;
+            f[k++] = report.maxDepthReached;
+            f[k++] = report.deadEndsNearTop1Count;
+            f[k++] = report.deadEndsNearTop3Count;
+            // Move analysis features (top solutions)
+            f[k++] = report.stepsInBoxTop1;
+            f[k++] = report.stepsFreeTop1;
+            f[k++] = report.dedupMovesLenTop1;
+            f[k++] = (float)report.stepsInBoxTop3Avg;
+            f[k++] = (float)report.stepsFreeTop3Avg;
+            f[k++] = (float)report.dedupMovesLenTop3Avg;
+            f[k++] = report.solvedTag == "false" && report.nodesExplored == 0 ? 0 : 1;
+            f[k++] = report.solvedTag == "capped" ? 1 : 0;
+            return f;
         }
+    }
 
-        // Minimal expression evaluator for +,-,*,/, parentheses and variable names
-        static double EvalExpr(string expr, IReadOnlyDictionary<string, float> vars)
-        {
-            var tokens = Tokenize(expr);
-            int i = 0;
-            double ParsePrimary()
-            {
-                if (i >= tokens.Count) throw new Exception("unexpected end");
-                var t = tokens[i++];
-                if (t.kind == "num") return t.num;
-                if (t.kind == "id") return vars.TryGetValue(t.text, out var v) ? v : 0.0;
-                if (t.text == "(") { var v = ParseAddSub(); if (i>=tokens.Count || tokens[i++].text!=")") throw new Exception("paren"); return v; }
-                if (t.text == "+") return +ParsePrimary();
-                if (t.text == "-") return -ParsePrimary();
-                throw new Exception("bad token");
-            }
-            double ParseMulDiv()
-            {
-                double v = ParsePrimary();
-                while (i < tokens.Count && (tokens[i].text == "*" || tokens[i].text == "/"))
-                {
-                    string op = tokens[i++].text; double rhs = ParsePrimary();
-                    v = op == "*" ? v * rhs : v / (Math.Abs(rhs) < 1e-12 ? 1e-12 : rhs);
-                }
-                return v;
-            }
-            double ParseAddSub()
-            {
-                double v = ParseMulDiv();
-                while (i < tokens.Count && (tokens[i].text == "+" || tokens[i].text == "-"))
-                {
-                    string op = tokens[i++].text; double rhs = ParseMulDiv();
-                    v = op == "+" ? v + rhs : v - rhs;
-                }
-                return v;
-            }
-            return ParseAddSub();
-        }
+    // A bucket's feature configs resolved to schema slots once; ids the schema lacks read as 0
+    public sealed class BucketScorer
+    {
+        readonly FeatureConfig[] features;
+        readonly int[] slots;
+        readonly int capped;
 
-        static List<(string kind, string text, double num)> Tokenize(string s)
+        public BucketScorer(BucketConfig bucket, FeatureSchema schema)
         {
-            var list = new List<(string,string,double)>();
-            int n = s.Length, i = 0;
-            while (i < n)
-            {
-                char c = s[i];
-                if (char.IsWhiteSpace(c)) { i++; continue; }
-                if (char.IsDigit(c) || c=='.')
-                {
-                    int j=i; while (j<n && (char.IsDigit(s[j]) || s[j]=='.')) j++;
-                    var sub = s.Substring(i, j-i);
-                    double val = 0; double.TryParse(sub, System.Globalization.NumberStyles.Float, System.Globalization.CultureInfo.InvariantCulture, out val);
-                    list.Add(("num", sub, val)); i=j; continue;
-                }
-                if (char.IsLetter(c) || c=='_' )
-                {
-                    int j=i; while (j<n && (char.IsLetterOrDigit(s[j]) || s[j]=='_' )) j++;
-                    var id = s.Substring(i, j-i);
-                    list.Add(("id", id, 0)); i=j; continue;
-                }
-                // operators and parens
-                list.Add(("sym", c.ToString(), 0)); i++;
-            }
-            return list;
+            features = bucket.features.ToArray();
+            slots = new int[features.Length];
+            for (int i = 0; i < features.Length; i++) slots[i] = schema.SlotOf(features[i].id);
+            capped = schema.SlotOf("capped");
         }
 
-        public static (float raw, bool reject) Score(BucketConfig bucket, Dictionary<string, float> features, float acceptCappedWeight)
+        public (float raw, bool reject) Score(float[] f, float acceptCappedWeight)
         {
             float raw = 0f; bool reject = false;
-            foreach (var fc in bucket.features)
+            for (int i = 0; i < features.Length; i++)
             {
-                float val = features.TryGetValue(fc.id, out var v) ? v : 0f;
+                var fc = features[i];
+                float val = slots[i] >= 0 ? f[slots[i]] : 0f;
                 float s = 0f;
                 if (fc.mode == FeatureMode.Band)
                 {
@@ -133,7 +84,7 @@ namespace SlimeGrid.Tools.ALD
                 raw += fc.weight * s;
             }
             // If capped, weight down
-            if (features.TryGetValue("capped", out var capped) && capped > 0.5f)
+            if (capped >= 0 && f[capped] > 0.5f)
                 raw *= acceptCappedWeight;
             return (raw, reject);
         }
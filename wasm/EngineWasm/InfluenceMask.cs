@@ -1,3 +1,4 @@
+using System;
 using System.Collections.Generic;
 using SlimeGrid.Logic;
 
@@ -45,7 +46,7 @@ namespace SlimeGrid.Tools.ALD
             return mask;
         }
 
-        public static string ReachableSignature(GameState s, bool[,] mask)
+        public static ulong ReachableSignature(GameState s, bool[,] mask)
         {
             unchecked
             {
@@ -55,7 +56,7 @@ namespace SlimeGrid.Tools.ALD
                     {
                         if (!mask[x, y]) continue;
                         var p = new V2(x, y);
-                        var c = s.Grid.CellRef(p);
+                        ref readonly var c = ref s.Grid.CellRef(p);
                         h ^= (ulong)c.Type; h *= 1099511628211UL;
                         if (s.EntityAt.TryGetValue(p, out var id))
                         {
@@ -66,8 +67,92 @@ namespace SlimeGrid.Tools.ALD
                 // include player pos
                 h ^= (ulong)(uint)s.PlayerPos.x; h *= 1099511628211UL;
                 h ^= (ulong)(uint)s.PlayerPos.y; h *= 1099511628211UL;
-                return h.ToString("X16");
+                return h;
             }
         }
+
+        // ReachableSignature made invariant under the board's 8 symmetries (4 quarter turns,
+        // with and without a left-right mirror): the hash is taken in each transformed frame
+        // and the smallest one kept, so rotated or mirrored copies dedupe as one level.
+        // Entity orientations turn with the board (triangles keep their corner).
+        public static ulong CanonicalSignature(GameState s, bool[,] mask)
+        {
+            int W = s.Grid.W, H = s.Grid.H;
+            var tiles = new int[W * H];    // per transformed cell, -1 => outside mask
+            var ents = new int[W * H];     // (type << 8) | orientation, -1 => none
+            ulong best = ulong.MaxValue;
+            unchecked
+            {
+                for (int t = 0; t < 8; t++)
+                {
+                    bool mirror = t >= 4; int turns = t & 3;
+                    int tw = (turns & 1) == 0 ? W : H;
+                    Array.Fill(tiles, -1);
+                    Array.Fill(ents, -1);
+                    for (int y = 0; y < H; y++)
+                        for (int x = 0; x < W; x++)
+                        {
+                            if (!mask[x, y]) continue;
+                            var p = new V2(x, y);
+                            var q = Map(p, W, H, mirror, turns);
+                            int i = q.y * tw + q.x;
+                            tiles[i] = (int)s.Grid.CellRef(p).Type;
+                            if (s.EntityAt.TryGetValue(p, out var id))
+                            {
+                                var e = s.EntitiesById[id];
+                                ents[i] = ((int)e.Type << 8) | (byte)MapOrientation(e, mirror, turns);
+                            }
+                        }
+
+                    ulong h = 1469598103934665603UL;
+                    h ^= (ulong)tw; h *= 1099511628211UL;
+                    for (int i = 0; i < tiles.Length; i++)
+                    {
+                        if (tiles[i] < 0) continue;
+                        h ^= (ulong)tiles[i]; h *= 1099511628211UL;
+                        if (ents[i] >= 0) { h ^= (ulong)ents[i]; h *= 1099511628211UL; }
+                    }
+                    var pp = Map(s.PlayerPos, W, H, mirror, turns);
+                    h ^= (ulong)(uint)pp.x; h *= 1099511628211UL;
+                    h ^= (ulong)(uint)pp.y; h *= 1099511628211UL;
+                    if (h < best) best = h;
+                }
+            }
+            return best;
+        }
+
+        // Optional x-mirror, then quarter turns of (x, y) -> (h-1-y, x) on a w x h board
+        // (with y pointing north this takes N to W, like the editor's rotate button).
+        static V2 Map(V2 p, int w, int h, bool mirror, int turns)
+        {
+            int x = mirror ? w - 1 - p.x : p.x, y = p.y;
+            for (int r = 0; r < turns; r++)
+            {
+                int nx = h - 1 - y;
+                y = x; x = nx;
+                (w, h) = (h, w);
+            }
+            return new V2(x, y);
+        }
+
+        static Dir MapDir(Dir d, bool mirror, int turns)
+        {
+            if (mirror && (d == Dir.E || d == Dir.W)) d = d.Opposite();
+            return (Dir)(((int)d + 3 * turns) & 3);
+        }
+
+        static Orientation MapOrientation(Entity e, bool mirror, int turns)
+        {
+            if (e.Behavior != BehaviorId.Triangle) return (Orientation)MapDir(e.Orientation.ToDir(), mirror, turns);
+
+            var (a, b) = e.Orientation.ToTri().FaceDirs();
+            a = MapDir(a, mirror, turns); b = MapDir(b, mirror, turns);
+            for (var o = Orientation.N; o <= Orientation.W; o++)
+            {
+                var f = o.ToTri().FaceDirs();
+                if ((f.a == a && f.b == b) || (f.a == b && f.b == a)) return o;
+            }
+            return e.Orientation;
+        }
     }
 }
@@ -0,0 +1,100 @@
+using System;
+using System.Collections.Generic;
+using SlimeGrid.Logic;
+
+namespace SlimeGrid.Tools.ALD
+{
+    // Mutable level for ALD operators: tile types by cell (y*W + x), the authoring entity list
+    // (PlayerSpawn included, last one wins like the Loader) and any legacy sparse tiles.
+    // Built once from a LevelDTO; Clone copies two arrays and ToState skips name parsing.
+    // Entity entries are never edited in place, so clones share them.
+    public sealed class LevelModel
+    {
+        public readonly int W, H;
+        public readonly TileType[] Tiles;
+        public readonly List<EntityDTO> Entities;
+        readonly List<TileDTO>? legacyTiles; // per-cell trait overrides, carried through untouched
+
+        LevelModel(int w, int h, TileType[] tiles, List<EntityDTO> entities, List<TileDTO>? legacyTiles)
+        {
+            W = w; H = h;
+            Tiles = tiles;
+            Entities = entities;
+            this.legacyTiles = legacyTiles;
+        }
+
+        public static LevelModel FromDTO(LevelDTO dto)
+        {
+            // Loader resolves every grid format (tileGrid, tileCharGrid + legend, sparse tiles)
+            var s = Loader.FromDTO(dto);
+            int w = s.Grid.W, h = s.Grid.H;
+            var tiles = new TileType[w * h];
+            for (int y = 0; y < h; y++)
+                for (int x = 0; x < w; x++)
+                    tiles[y * w + x] = s.Grid.CellRef(new V2(x, y)).Type;
+
+            var entities = new List<EntityDTO>(dto.entities?.Count ?? 0);
+            foreach (var e in dto.entities ?? new List<EntityDTO>())
+                if (e != null) entities.Add(Copy(e));
+            var legacy = dto.tiles != null && dto.tiles.Count > 0 ? new List<TileDTO>(dto.tiles) : null;
+            return new LevelModel(w, h, tiles, entities, legacy);
+        }
+
+        public LevelModel Clone() =>
+            new LevelModel(W, H, (TileType[])Tiles.Clone(), new List<EntityDTO>(Entities), legacyTiles);
+
+        public bool HasLegacyTiles => legacyTiles != null;
+
+        public TileType this[int x, int y]
+        {
+            get => Tiles[y * W + x];
+            set => Tiles[y * W + x] = value;
+        }
+
+        public bool HasEntityAt(int x, int y)
+        {
+            foreach (var e in Entities)
+                if (e.type != EntityType.PlayerSpawn && e.x == x && e.y == y) return true;
+            return false;
+        }
+
+        public void AddEntity(EntityType type, int x, int y)
+        {
+            if (type == EntityType.PlayerSpawn) Entities.RemoveAll(e => e.type == EntityType.PlayerSpawn);
+            Entities.Add(new EntityDTO { type = type, x = x, y = y });
+        }
+
+        public GameState ToState()
+        {
+            // Sparse legacy tiles carry per-cell trait overrides; let the Loader apply them.
+            if (legacyTiles != null) return Loader.FromDTO(ToDTO());
+            return Loader.FromTileTypes(W, H, Tiles, Entities);
+        }
+
+        public LevelDTO ToDTO()
+        {
+            var grid = new string[H][];
+            for (int y = 0; y < H; y++)
+            {
+                var row = grid[y] = new string[W];
+                for (int x = 0; x < W; x++) row[x] = Tiles[y * W + x].ToString();
+            }
+            var entities = new List<EntityDTO>(Entities.Count);
+            foreach (var e in Entities) entities.Add(Copy(e));
+            return new LevelDTO
+            {
+                width = W, height = H,
+                tileGrid = grid,
+                tiles = legacyTiles != null ? new List<TileDTO>(legacyTiles) : new List<TileDTO>(),
+                entities = entities
+            };
+        }
+
+        static EntityDTO Copy(EntityDTO e) => new EntityDTO
+        {
+            x = e.x, y = e.y, type = e.type,
+            orientation = e.orientation, behavior = e.behavior,
+            traitsAdd = e.traitsAdd, traitsRemove = e.traitsRemove, traitsXor = e.traitsXor
+        };
+    }
+}
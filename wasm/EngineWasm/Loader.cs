@@ -105,7 +105,7 @@ namespace SlimeGrid.Logic
                     var cell = s.Grid.CellRef(p);
                     cell.Type = ttype;
                     ApplyRecipeToCell(ref cell, TileTraits.For(ttype));
-                    s.Grid.CellRef(p) = cell;
+                    s.Grid.SetCell(p, cell);
                 }
             }
 
@@ -166,29 +166,8 @@ namespace SlimeGrid.Logic
             if (dto.width <= 0 || dto.height <= 0)
                 throw new System.Exception("Level width/height must be > 0 (provide via grid or fields).");
 
-            // 1) Allocate state
-            var s = new GameState
-            {
-                Grid = new Grid2D(dto.width, dto.height),
-                PlayerPos = new V2(0, 0),
-                AnyButtonPressed = false,
-                LastAnyButtonPressed = false // ensure button edge events are correct
-            };
-
-            // 2) Prefill entire grid as Floor (explicit default)
-            for (int y = 0; y < s.Grid.H; y++)
-                for (int x = 0; x < s.Grid.W; x++)
-                {
-                    var p = new V2(x, y);
-                    var cell = new Cell
-                    {
-                        Type = TileType.Floor,
-                        Orientation = Orientation.N,
-                        Toggled = false
-                    };
-                    ApplyRecipeToCell(ref cell, TileTraits.For(TileType.Floor));
-                    s.Grid.SetCell(p, cell);
-                }
+            // 1) Allocate state, 2) prefill entire grid as Floor (explicit default)
+            var s = NewFloorState(dto.width, dto.height);
 
             // 3) Grid-based authoring (preferred)
             if (dto.tileGrid != null && dto.tileGrid.Length > 0)
@@ -209,7 +188,7 @@ namespace SlimeGrid.Logic
                         var cell = s.Grid.CellRef(p);
                         cell.Type = ttype;
                         ApplyRecipeToCell(ref cell, TileTraits.For(ttype));
-                        s.Grid.CellRef(p) = cell;
+                        s.Grid.SetCell(p, cell);
                     }
                 }
             }
@@ -233,7 +212,7 @@ namespace SlimeGrid.Logic
                         var cell = s.Grid.CellRef(p);
                         cell.Type = ttype;
                         ApplyRecipeToCell(ref cell, TileTraits.For(ttype));
-                        s.Grid.CellRef(p) = cell;
+                        s.Grid.SetCell(p, cell);
                     }
                 }
             }
@@ -291,31 +270,82 @@ namespace SlimeGrid.Logic
             }
 
             // 6) Entities (unchanged)
-            if (dto.entities != null)
+            if (dto.entities != null) SpawnEntities(s, dto.entities);
+
+            return s;
+        }
+
+        // Tile types given directly (index y*w + x) instead of by name, e.g. from the ALD level
+        // model: same state as FromDTO on the equivalent tileGrid, without parsing.
+        public static GameState FromTileTypes(int w, int h, TileType[] tiles, IEnumerable<EntityDTO> entities)
+        {
+            if (w <= 0 || h <= 0) throw new System.Exception("Level width/height must be > 0 (provide via grid or fields).");
+            if (tiles == null || tiles.Length != w * h) throw new System.Exception("Tile array length must equal width*height.");
+
+            var s = NewFloorState(w, h);
+            for (int y = 0; y < h; y++)
+                for (int x = 0; x < w; x++)
+                {
+                    var ttype = tiles[y * w + x];
+                    if (ttype == TileType.Floor) continue;
+                    var p = new V2(x, y);
+                    var cell = s.Grid.CellRef(p);
+                    cell.Type = ttype;
+                    ApplyRecipeToCell(ref cell, TileTraits.For(ttype));
+                    s.Grid.SetCell(p, cell);
+                }
+            if (entities != null) SpawnEntities(s, entities);
+            return s;
+        }
+
+        // --------- Helpers ---------------------------------------------------
+        static GameState NewFloorState(int w, int h)
+        {
+            var s = new GameState
             {
-                foreach (var e in dto.entities)
+                Grid = new Grid2D(w, h),
+                PlayerPos = new V2(0, 0),
+                AnyButtonPressed = false,
+                LastAnyButtonPressed = false // ensure button edge events are correct
+            };
+
+            for (int y = 0; y < s.Grid.H; y++)
+                for (int x = 0; x < s.Grid.W; x++)
                 {
-                    if (e.type == EntityType.PlayerSpawn)
+                    var p = new V2(x, y);
+                    var cell = new Cell
                     {
-                        s.PlayerPos = new V2(e.x, e.y);
-                        continue;
-                    }
-
-                    var ent = EntityCatalog.Spawn(s, e.type, new V2(e.x, e.y));
+                        Type = TileType.Floor,
+                        Orientation = Orientation.N,
+                        Toggled = false
+                    };
+                    ApplyRecipeToCell(ref cell, TileTraits.For(TileType.Floor));
+                    s.Grid.SetCell(p, cell);
+                }
+            return s;
+        }
 
-                    // Optional overrides
-                    if (e.orientation.HasValue) ent.Orientation = e.orientation.Value;
-                    if (e.behavior.HasValue) ent.Behavior = e.behavior.Value;
-                    if (e.traitsAdd.HasValue) ent.Traits |= e.traitsAdd.Value;
-                    if (e.traitsRemove.HasValue) ent.Traits &= ~e.traitsRemove.Value;
-                    if (e.traitsXor.HasValue) ent.Traits ^= e.traitsXor.Value;
+        static void SpawnEntities(GameState s, IEnumerable<EntityDTO> entities)
+        {
+            foreach (var e in entities)
+            {
+                if (e.type == EntityType.PlayerSpawn)
+                {
+                    s.PlayerPos = new V2(e.x, e.y);
+                    continue;
                 }
-            }
 
-            return s;
+                var ent = EntityCatalog.Spawn(s, e.type, new V2(e.x, e.y));
+
+                // Optional overrides
+                if (e.orientation.HasValue) ent.Orientation = e.orientation.Value;
+                if (e.behavior.HasValue) ent.Behavior = e.behavior.Value;
+                if (e.traitsAdd.HasValue) ent.Traits |= e.traitsAdd.Value;
+                if (e.traitsRemove.HasValue) ent.Traits &= ~e.traitsRemove.Value;
+                if (e.traitsXor.HasValue) ent.Traits ^= e.traitsXor.Value;
+            }
         }
 
-        // --------- Helpers ---------------------------------------------------
         static void ApplyRecipeToCell(ref Cell cell, TT recipe)
         {
             cell.ActiveMask = recipe.Active;
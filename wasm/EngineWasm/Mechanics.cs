@@ -1,3 +1,4 @@
+using System;
 using System.Collections.Generic;
 using SlimeGrid.Logic.Animation;
 
@@ -5,22 +6,26 @@ namespace SlimeGrid.Logic
 {
     public static class Mechanics
     {
+        // Per-thread scratch for PushChain (not re-entrant: Tumble calls it after, never inside)
+        [ThreadStatic] static List<int>? chainScratch;
+
         static bool InB(GameState s, V2 p) => s.Grid.InBounds(p);
         static V2 Next(V2 p, Dir d) => p + d.Vec();
 
         // -------------------- WALK (tile-first; single MoveStraight) --------------------
-        public static bool Walk(GameState s, Dir d, StepResult outRes)
+        public static bool Walk<TSink>(GameState s, Dir d, ref TSink outRes) where TSink : IStepSink
         {
-            if (DoSlidePlayer(s, s.PlayerPos, d, outRes)) return true;
-            if (DoPlayerStep(s, d, outRes)) return true;
+            if (DoSlidePlayer(s, s.PlayerPos, d, ref outRes)) return true;
+            if (DoPlayerStep(s, d, ref outRes)) return true;
             return false;
         }
 
         // -------------------- PUSH CHAIN (tile-first; validate every step) -------------
-        public static bool PushChain(GameState s, int rootEntityId, Dir d, StepResult outRes)
+        public static bool PushChain<TSink>(GameState s, int rootEntityId, Dir d, ref TSink outRes) where TSink : IStepSink
         {
             // Build contiguous pushable chain
-            var chain = new List<int>();
+            var chain = chainScratch ??= new List<int>();
+            chain.Clear();
             var cur = s.EntitiesById[rootEntityId].Pos;
 
             while (s.EntityAt.TryGetValue(cur, out var id))
@@ -53,8 +58,8 @@ namespace SlimeGrid.Logic
                 var mask = TraitsUtil.ResolveEffectiveMask(s, pos);
                 if (blocked || (mask & Traits.StopsEntity) != 0 || (mask & Traits.SticksEntity) != 0)
                 {
-                    outRes.Add(new Blocked(Actor.Entity, Verb.PushChain, d, pos, BlockReason.TileStopsEntity));
-                    Anim.Bump(outRes, pos);
+                    if (outRes.Records) outRes.Add(new Blocked(Actor.Entity, Verb.PushChain, d, pos, BlockReason.TileStopsEntity));
+                    Anim.Bump(ref outRes, pos);
                     blocked = true;
                 }
             }
@@ -65,14 +70,14 @@ namespace SlimeGrid.Logic
             for (int i = chain.Count - 1; i >= 0; i--)
             {
                 var eid = chain[i];
-                if (!DoSlideEntity(s, eid, d, outRes))
-                    DoEntityPushStep(s, eid, d, outRes);
+                if (!DoSlideEntity(s, eid, d, ref outRes))
+                    DoEntityPushStep(s, eid, d, ref outRes);
             }
             return true;
         }
 
         // -------------------- TUMBLE (tile-first; no push fallback here) --------------
-        public static bool Tumble(GameState s, int entityId, Dir d, StepResult outRes)
+        public static bool Tumble<TSink>(GameState s, int entityId, Dir d, ref TSink outRes) where TSink : IStepSink
         {
             var cur = s.EntitiesById[entityId].Pos;
             var to = Next(cur, d);
@@ -80,93 +85,91 @@ namespace SlimeGrid.Logic
             // If next tile stops tumble and player is NOT side-attached, fail
             if ((TraitsUtil.ResolveEffectiveMask(s, to) & Traits.StopsTumble) != 0 && s.EntryDir is not Dir)
             {
-                outRes.Add(new Blocked(Actor.Entity, Verb.Tumble, d, to, BlockReason.StopsTumble));
-                Anim.Bump(outRes, to);
+                if (outRes.Records) outRes.Add(new Blocked(Actor.Entity, Verb.Tumble, d, to, BlockReason.StopsTumble));
+                Anim.Bump(ref outRes, to);
                 return false;
             }
             // If current tile is Slippery => defer to PushChain
             if ((TraitsUtil.ResolveEffectiveMask(s, cur) & Traits.Slipery) != 0)
-                return PushChain(s, entityId, d, outRes);
+                return PushChain(s, entityId, d, ref outRes);
 
             // If next tile stops entity => fail
             if ((TraitsUtil.ResolveEffectiveMask(s, to) & Traits.StopsEntity) != 0)
             {
-                outRes.Add(new Blocked(Actor.Entity, Verb.Tumble, d, to, BlockReason.TileStopsEntity));
-                Anim.Bump(outRes, to);
+                if (outRes.Records) outRes.Add(new Blocked(Actor.Entity, Verb.Tumble, d, to, BlockReason.TileStopsEntity));
+                Anim.Bump(ref outRes, to);
                 return false;
             }
             // If next tile stops tumble => push chain instead
             if ((TraitsUtil.ResolveEffectiveMask(s, to) & Traits.StopsTumble) != 0)
-                return PushChain(s, entityId, d, outRes);
+                return PushChain(s, entityId, d, ref outRes);
 
             // If next is Slippery => tumble once, then push chain forward
             if ((TraitsUtil.ResolveEffectiveMask(s, to) & Traits.Slipery) != 0)
             {
-                DoTumble(s, entityId, d, outRes);
-                return PushChain(s, entityId, d, outRes);
+                DoTumble(s, entityId, d, ref outRes);
+                return PushChain(s, entityId, d, ref outRes);
             }
 
-            DoTumble(s, entityId, d, outRes);
+            DoTumble(s, entityId, d, ref outRes);
             return true;
         }
 
         // -------------------- FLY (tile-first; Stop BEFORE; entity decides) ----------
-        public static bool Fly(GameState s, Dir d, StepResult outRes)
+        public static bool Fly<TSink>(GameState s, Dir d, ref TSink outRes) where TSink : IStepSink
         {
             var from = s.PlayerPos;
             var next = CheckFly(s, d);
             if (next.Equals(from)) return false;
 
             // Authoritative motion event for presenter
-            Anim.PlayerMove(outRes, from, next, d, "fly");
+            Anim.PlayerMove(ref outRes, from, next, d, "fly");
 
             // Mutate logic state
             s.PlayerPos = next;
             s.AttachedEntityId = null;
             s.EntryDir = null;
-            Anim.SetAttachment(outRes, null, null);
+            Anim.SetAttachment(ref outRes, null, null);
 
-            // Break breakables passed over — gather first, then remove
-            var toBreak = new List<int>();
-            foreach (var kv in s.EntitiesById)
-            {
-                var eid = kv.Key;
-                var e = kv.Value;
-                if ((TraitsUtil.ResolveEffectiveMask(s, e.Pos) & Traits.Breakable) == 0) continue;
-                if (e.Pos.Equals(from)) continue;
-                if (e.Pos.x > from.x && e.Pos.x < next.x && e.Pos.y > from.y && e.Pos.y < next.y)
-                    toBreak.Add(eid);
-            }
-            foreach (var eid in toBreak)
+            // Break breakables passed over: cells strictly between start and landing, looked up
+            // in EntityAt along the segment (removing as we go leaves later cells untouched)
+            for (var pos = from + d.Vec(); !pos.Equals(next); pos += d.Vec())
             {
-                var pos = s.EntitiesById[eid].Pos;
+                if (!s.EntityAt.TryGetValue(pos, out var eid)) continue;
+                if ((TraitsUtil.ResolveEffectiveMask(s, pos) & Traits.Breakable) == 0) continue;
+                ButtonCounters.Track(s, s.EntitiesById[eid], pos, -1);
                 s.EntityAt.Remove(pos);
+                s.Moves?.Vacate(s, pos);
                 s.EntitiesById.Remove(eid);
-                outRes.Add(new DestroyEntity(eid, pos, "break"));
-                Anim.BreakImpact(outRes, pos);
+                if (outRes.Records) outRes.Add(new DestroyEntity(eid, pos, "break"));
+                Anim.BreakImpact(ref outRes, pos);
             }
             return true;
         }
 
         // -------------------- HELPERS --------------------
 
-        private static void EntityMovement(GameState s, V2 from, V2 to, StepResult outRes, int entityId, string kind)
+        private static void EntityMovement<TSink>(GameState s, V2 from, V2 to, ref TSink outRes, int entityId, string kind) where TSink : IStepSink
         {
+            var e = s.EntitiesById[entityId];
             s.EntityAt.Remove(from);
             s.EntityAt[to] = entityId;
-            s.EntitiesById[entityId].Pos = to;
+            if (s.Moves != null) { s.Moves.Vacate(s, from); s.Moves.Occupy(s, to); }
+            ButtonCounters.Track(s, e, from, -1);
+            ButtonCounters.Track(s, e, to, +1);
+            e.Pos = to;
             FixPlayerPos(s);
-            Anim.EntityMove(outRes, entityId, from, to, kind);
+            Anim.EntityMove(ref outRes, entityId, from, to, kind);
         }
 
-        private static bool DoTumble(GameState s, int entityId, Dir d, StepResult outRes)
+        private static bool DoTumble<TSink>(GameState s, int entityId, Dir d, ref TSink outRes) where TSink : IStepSink
         {
-            if (!CheckEntityMovement(s, entityId, d, outRes)) return false;
+            if (!CheckEntityMovement(s, entityId, d, ref outRes)) return false;
 
             var cur = s.EntitiesById[entityId].Pos;
             var to = Next(cur, d);
 
-            EntityMovement(s, cur, to, outRes, entityId, "tumble");
+            EntityMovement(s, cur, to, ref outRes, entityId, "tumble");
 
             if (s.EntryDir is Dir ed)
             {
@@ -180,18 +183,18 @@ namespace SlimeGrid.Logic
             return true;
         }
 
-        private static bool DoEntityPushStep(GameState s, int entityId, Dir d, StepResult outRes)
+        private static bool DoEntityPushStep<TSink>(GameState s, int entityId, Dir d, ref TSink outRes) where TSink : IStepSink
         {
-            if (!CheckEntityMovement(s, entityId, d, outRes)) return false;
+            if (!CheckEntityMovement(s, entityId, d, ref outRes)) return false;
 
             var cur = s.EntitiesById[entityId].Pos;
             var to = Next(cur, d);
 
-            EntityMovement(s, cur, to, outRes, entityId, "push");
+            EntityMovement(s, cur, to, ref outRes, entityId, "push");
             return true;
         }
 
-        private static bool CheckEntityMovement(GameState s, int entityId, Dir d, StepResult outRes)
+        private static bool CheckEntityMovement<TSink>(GameState s, int entityId, Dir d, ref TSink outRes) where TSink : IStepSink
         {
             var cur = s.EntitiesById[entityId].Pos;
             var to = cur + d.Vec();
@@ -199,49 +202,51 @@ namespace SlimeGrid.Logic
             return true;
         }
 
-        private static bool DoPlayerStep(GameState s, Dir d, StepResult outRes)
+        private static bool DoPlayerStep<TSink>(GameState s, Dir d, ref TSink outRes) where TSink : IStepSink
         {
-            if (!CheckPlayerMovement(s, d, outRes)) return false;
+            if (!CheckPlayerMovement(s, d, ref outRes)) return false;
 
             var from = s.PlayerPos;
             var to = from + d.Vec();
 
             s.PlayerPos = to;
-            Anim.PlayerMove(outRes, from, to, d, "step");
+            Anim.PlayerMove(ref outRes, from, to, d, "step");
             return true;
         }
 
-        private static bool CheckPlayerMovement(GameState s, Dir d, StepResult outRes)
+        private static bool CheckPlayerMovement<TSink>(GameState s, Dir d, ref TSink outRes) where TSink : IStepSink
         {
             var to = s.PlayerPos + d.Vec();
             if (TraitsUtil.TileStopsPlayer(s, to) || s.AttachedEntityId is not null) return false;
             return true;
         }
 
-        private static bool DoSlideEntity(GameState s, int entityId, Dir d, StepResult outRes)
+        private static bool DoSlideEntity<TSink>(GameState s, int entityId, Dir d, ref TSink outRes) where TSink : IStepSink
         {
             var to = CheckSlideEntity(s, entityId, d);
             var cur = s.EntitiesById[entityId].Pos;
             if (cur.Equals(to)) return false;
 
-            EntityMovement(s, cur, to, outRes, entityId, "slide");
+            EntityMovement(s, cur, to, ref outRes, entityId, "slide");
             return true;
         }
 
-        private static bool DoSlidePlayer(GameState s, V2 cur, Dir d, StepResult outRes)
+        private static bool DoSlidePlayer<TSink>(GameState s, V2 cur, Dir d, ref TSink outRes) where TSink : IStepSink
         {
             var to = CheckSlidePlayer(s, cur, d);
             if (cur.Equals(to)) return false;
 
             s.PlayerPos = to;
-            Anim.PlayerMove(outRes, cur, to, d, "slide");
+            Anim.PlayerMove(ref outRes, cur, to, d, "slide");
             return true;
         }
 
         private static V2 CheckSlideEntity(GameState s, int entityId, Dir d)
         {
-            var v = d.Vec();
             var pos = s.EntitiesById[entityId].Pos;
+            if (s.Moves != null) return s.Moves.SlideEntity(s, pos, d);
+
+            var v = d.Vec();
             var cur = pos + v;
 
             if (TraitsUtil.TileStopsEntity(s, cur) || s.TryGetEntityAt(cur) is not null) return pos;
@@ -257,6 +262,8 @@ namespace SlimeGrid.Logic
 
         private static V2 CheckSlidePlayer(GameState s, V2 pos, Dir d)
         {
+            if (s.Moves != null) return s.Moves.SlidePlayer(s, pos, d);
+
             var v = d.Vec();
             var cur = pos + v;
 
@@ -279,6 +286,8 @@ namespace SlimeGrid.Logic
 
         private static V2 CheckFly(GameState s, Dir d)
         {
+            if (s.Moves != null) return s.Moves.Fly(s, d);
+
             var cur = s.PlayerPos;
             while (true)
             {
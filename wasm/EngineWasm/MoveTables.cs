@@ -0,0 +1,144 @@
+// File: Assets/Code/Logic/MoveTables.cs
+// Scope: per-level slide/flight destination tables + entity occupancy bits (solver fast path)
+
+namespace SlimeGrid.Logic
+{
+    // Tile-only destinations for every (cell, dir, button parity): where a slide or flight
+    // would end if no entity were in the way. Mechanics then only tests occupancy along that
+    // segment. Only valid while toggles depend on buttons alone, so TryBuild refuses levels
+    // with ToggleableByEntity/ToggleableByPlayer tiles and callers keep the cell walk there.
+    public sealed class MoveTables
+    {
+        readonly int W, H;
+        readonly int[] slidePlayer;
+        readonly int[] slideEntity;
+        readonly int[] fly;
+
+        MoveTables(int w, int h)
+        {
+            W = w; H = h;
+            slidePlayer = new int[w * h * 8];
+            slideEntity = new int[w * h * 8];
+            fly = new int[w * h * 8];
+        }
+
+        static int Key(int cell, Dir d, bool pressed) => ((cell << 2) | (int)d) << 1 | (pressed ? 1 : 0);
+
+        public static MoveTables? TryBuild(Grid2D g)
+        {
+            var lvl = g.Compiled;
+            foreach (var word in lvl.Dynamic) if (word != 0) return null;
+
+            var t = new MoveTables(g.W, g.H);
+            var masks = new Traits[2][];
+            for (int p = 0; p < 2; p++)
+            {
+                masks[p] = new Traits[g.W * g.H];
+                for (int i = 0; i < masks[p].Length; i++) masks[p][i] = lvl.ButtonPlane(i, p == 1);
+            }
+
+            for (int i = 0; i < g.W * g.H; i++)
+                for (int d = 0; d < 4; d++)
+                    for (int p = 0; p < 2; p++)
+                    {
+                        int k = Key(i, (Dir)d, p == 1);
+                        t.slidePlayer[k] = t.WalkSlide(masks[p], i, (Dir)d, Traits.StopsPlayer);
+                        t.slideEntity[k] = t.WalkSlide(masks[p], i, (Dir)d, Traits.StopsEntity);
+                        t.fly[k] = t.WalkFly(masks[p], i, (Dir)d);
+                    }
+            return t;
+        }
+
+        // Attach tables and occupancy to a state whose clones share them (solver roots).
+        public static void Attach(GameState s)
+        {
+            s.Moves = TryBuild(s.Grid);
+            if (s.Moves == null) return;
+            s.Occupancy = new ulong[(s.Grid.W * s.Grid.H + 63) >> 6];
+            foreach (var p in s.EntityAt.Keys) s.Moves.Occupy(s, p);
+        }
+
+        // Out-of-bounds behaves like ResolveTileMask: stops everything, never slippery.
+        Traits MaskAt(Traits[] m, int x, int y)
+            => (x < 0 || y < 0 || x >= W || y >= H) ? Traits.StopsPlayer | Traits.StopsEntity | Traits.StopsFlight : m[y * W + x];
+
+        int WalkSlide(Traits[] m, int from, Dir d, Traits stop)
+        {
+            var (dx, dy) = d.Vec();
+            int x = from % W + dx, y = from / W + dy;
+            if ((MaskAt(m, x, y) & stop) != 0) return from;
+            while ((MaskAt(m, x, y) & Traits.Slipery) != 0 && (MaskAt(m, x + dx, y + dy) & stop) == 0)
+            { x += dx; y += dy; }
+            return y * W + x;
+        }
+
+        int WalkFly(Traits[] m, int from, Dir d)
+        {
+            var (dx, dy) = d.Vec();
+            int x = from % W, y = from / W;
+            while (true)
+            {
+                var next = MaskAt(m, x + dx, y + dy);
+                if ((next & Traits.StopsFlight) != 0) return y * W + x;
+                x += dx; y += dy;
+                if ((next & Traits.SticksFlight) != 0) return y * W + x;
+            }
+        }
+
+        int Index(V2 p) => p.y * W + p.x;
+        V2 At(int i) => new V2(i % W, i / W);
+        int Stride(Dir d) { var (dx, dy) = d.Vec(); return dx + dy * W; }
+
+        // Occupancy is allocated whenever Moves is, and these only run through Moves
+        static bool Occupied(GameState s, int i) => (s.Occupancy![i >> 6] & (1UL << (i & 63))) != 0;
+        public void Occupy(GameState s, V2 p) { int i = Index(p); s.Occupancy![i >> 6] |= 1UL << (i & 63); }
+        public void Vacate(GameState s, V2 p) { int i = Index(p); s.Occupancy![i >> 6] &= ~(1UL << (i & 63)); }
+
+        // Same results as Mechanics' cell walks: the first occupied cell on the segment
+        // either ends the move there or, if its entity blocks, one cell before it.
+        public V2 SlidePlayer(GameState s, V2 pos, Dir d)
+        {
+            int from = Index(pos), to = slidePlayer[Key(from, d, s.AnyButtonPressed)];
+            if (to == from) return pos;
+            int step = Stride(d);
+            for (int c = from + step; ; c += step)
+            {
+                if (Occupied(s, c))
+                {
+                    var e = s.EntitiesById[s.EntityAt[At(c)]];
+                    return (e.Traits & Traits.StopsPlayer) != 0 ? At(c - step) : At(c);
+                }
+                if (c == to) return At(to);
+            }
+        }
+
+        public V2 SlideEntity(GameState s, V2 pos, Dir d)
+        {
+            int from = Index(pos), to = slideEntity[Key(from, d, s.AnyButtonPressed)];
+            if (to == from) return pos;
+            int step = Stride(d);
+            for (int c = from + step; ; c += step)
+            {
+                if (Occupied(s, c)) return At(c - step);
+                if (c == to) return At(to);
+            }
+        }
+
+        public V2 Fly(GameState s, Dir d)
+        {
+            int from = Index(s.PlayerPos), to = fly[Key(from, d, s.AnyButtonPressed)];
+            if (to == from) return s.PlayerPos;
+            int step = Stride(d);
+            for (int c = from + step; ; c += step)
+            {
+                if (Occupied(s, c))
+                {
+                    var t = s.EntitiesById[s.EntityAt[At(c)]].Traits;
+                    if ((t & Traits.StopsFlight) != 0) return At(c - step);
+                    if ((t & Traits.SticksFlight) != 0) return At(c);
+                }
+                if (c == to) return At(to);
+            }
+        }
+    }
+}
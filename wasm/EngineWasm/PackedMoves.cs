@@ -1,5 +1,7 @@
 #if UNITY_EDITOR || EXPOSE_WASM
 using System;
+using System.Buffers.Binary;
+using System.Numerics;
 
 namespace SlimeGrid.Tools.Solver
 {
@@ -63,6 +65,30 @@ namespace SlimeGrid.Tools.Solver
             return new PackedMoves { Buffer = outBytes, Length = Length };
         }
 
+        // Number of leading moves shared by a and b. Compares the packed buffers
+        // 8 bytes (32 moves) at a time, then locates the first differing 2-bit lane.
+        public static int CommonPrefixLength(in PackedMoves a, in PackedMoves b)
+        {
+            int n = Math.Min(a.Length, b.Length);
+            if (n <= 0) return 0;
+            int bytes = (n + 3) >> 2;
+            var sa = new ReadOnlySpan<byte>(a.Buffer, 0, bytes);
+            var sb = new ReadOnlySpan<byte>(b.Buffer, 0, bytes);
+
+            int i = 0;
+            for (; i + 8 <= bytes; i += 8)
+            {
+                ulong x = BinaryPrimitives.ReadUInt64LittleEndian(sa.Slice(i)) ^ BinaryPrimitives.ReadUInt64LittleEndian(sb.Slice(i));
+                if (x != 0) return Math.Min(n, (i << 2) + (BitOperations.TrailingZeroCount(x) >> 1));
+            }
+            for (; i < bytes; i++)
+            {
+                uint x = (uint)(sa[i] ^ sb[i]);
+                if (x != 0) return Math.Min(n, (i << 2) + (BitOperations.TrailingZeroCount(x) >> 1));
+            }
+            return n;
+        }
+
         // Threshold-bounded Levenshtein on 2-bit sequences without allocations.
         public static bool EditDistanceLeq(in PackedMoves a, in PackedMoves b, int maxCost)
         {
@@ -1,5 +1,6 @@
 using System;
 using System.Collections.Generic;
+using System.Diagnostics.CodeAnalysis;
 using SlimeGrid.Logic;
 using SlimeGrid.Tools.Solver;
 
@@ -18,40 +19,43 @@ namespace SlimeGrid.Tools.ALD
             TileType.ButtonAllowExit, TileType.ButtonToggle
         };
 
-        public static bool TryApply(Random rng, GeneratorSettings cfg, GameState currentState, LevelDTO dtoIn, bool[,] influenceMask, out LevelDTO dtoOut)
+        public static bool TryApply(Random rng, GeneratorSettings cfg, LevelDTO dtoIn, bool[,] influenceMask, [NotNullWhen(true)] out LevelDTO? dtoOut)
         {
-            // Start from a copy of the DTO
-            var dto = CloneDTO(dtoIn);
+            dtoOut = TryApply(rng, cfg, LevelModel.FromDTO(dtoIn), influenceMask, out var level) ? level.ToDTO() : null;
+            return dtoOut != null;
+        }
+
+        public static bool TryApply(Random rng, GeneratorSettings cfg, LevelModel levelIn, bool[,] influenceMask, [NotNullWhen(true)] out LevelModel? levelOut)
+        {
+            levelOut = null;
 
             // Choose tile target with reachable focus
             bool focus = rng.NextDouble() < cfg.p_reachableFocus;
             var targets = new List<(int x, int y)>();
-            for (int y = 0; y < dto.height; y++)
-                for (int x = 0; x < dto.width; x++)
+            for (int y = 0; y < levelIn.H; y++)
+                for (int x = 0; x < levelIn.W; x++)
                 {
                     bool inMask = influenceMask[x, y];
                     if ((focus && inMask) || (!focus && !inMask)) targets.Add((x, y));
                 }
-            if (targets.Count == 0) { dtoOut = null; return false; }
+            if (targets.Count == 0) return false;
             var t = targets[rng.Next(targets.Count)];
 
             // Current tile
-            var curCell = currentState.Grid.CellRef(new V2(t.x, t.y));
+            var curType = levelIn[t.x, t.y];
 
             // Pick candidate tile type via similarity-biased sampling
-            TileType picked = curCell.Type;
-            if (!PickTileType(rng, cfg.similarity_bias, curCell.Type, out picked)) { dtoOut = null; return false; }
-            if (picked == curCell.Type) { dtoOut = null; return false; }
+            if (!PickTileType(rng, cfg.similarity_bias, curType, out var picked)) return false;
+            if (picked == curType) return false;
 
-            // Apply change into DTO
-            EnsureGridInitialized(dto);
-            dto.tileGrid[t.y][t.x] = picked.ToString();
+            // Apply change on a copy
+            var level = levelIn.Clone();
+            level[t.x, t.y] = picked;
 
             // Validate: change must touch influence mask (it does) and not violate constraints
-            var mutated = Loader.FromDTO(dto);
-            if (!ConstraintCheck(mutated)) { dtoOut = null; return false; }
+            if (!ConstraintCheck(level.ToState())) return false;
 
-            dtoOut = dto;
+            levelOut = level;
             return true;
         }
 
@@ -119,22 +123,5 @@ namespace SlimeGrid.Tools.ALD
             x = (x & 0x3333333333333333UL) + ((x >> 2) & 0x3333333333333333UL);
             return (int)(unchecked(((x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FUL) * 0x0101010101010101UL) >> 56);
         }
-
-        static LevelDTO CloneDTO(LevelDTO src)
-        {
-            var json = Newtonsoft.Json.JsonConvert.SerializeObject(src);
-            return Newtonsoft.Json.JsonConvert.DeserializeObject<LevelDTO>(json);
-        }
-
-        static void EnsureGridInitialized(LevelDTO dto)
-        {
-            if (dto.tileGrid != null && dto.tileGrid.Length > 0) return;
-            dto.tileGrid = new string[dto.height][];
-            for (int y = 0; y < dto.height; y++)
-            {
-                dto.tileGrid[y] = new string[dto.width];
-                for (int x = 0; x < dto.width; x++) dto.tileGrid[y][x] = TileType.Floor.ToString();
-            }
-        }
     }
 }
@@ -14,8 +14,15 @@ namespace SlimeGrid.Tools.Solver
         public int nodesExplored { get; set; }
         public int maxDepthReached { get; set; }
         public double elapsedSeconds { get; set; }
+        public int deadlockPrunedCount { get; set; } // children dropped by SolverConfig.PruneDeadlocks
+        public int stepsReused { get; set; }         // children taken from a SolveGraph instead of stepped
         public string solvedTag { get; set; } // "true" | "false" | "capped"
 
+        // SolverConfig.ExactStateKeys only (0 otherwise)
+        public int exactStatesCount { get; set; }      // distinct states interned in the arena
+        public int exactStateBytes { get; set; }       // packed size of one state
+        public int zobristCollisionCount { get; set; } // states whose Zobrist key an earlier distinct state had; -1 => not counted
+
         public int solutionsTotalCount { get; set; }
         public int solutionsFilteredCount { get; set; }
 
@@ -25,6 +32,8 @@ namespace SlimeGrid.Tools.Solver
         public double deadEndsAverageDepth { get; set; }
         public int deadEndsNearTop1Count { get; set; }
         public int deadEndsNearTop3Count { get; set; }
+        // [d] = dead-ends whose longest common prefix with the closest top-3 solution is d moves
+        public List<int> deadEndsDivergenceHistogram { get; set; } = new();
 
         // Extra move-analysis metrics (top solutions)
         public int stepsInBoxTop1 { get; set; }
@@ -44,6 +53,7 @@ namespace SlimeGrid.Tools.Solver
         public bool nodesHit { get; set; }
         public bool depthHit { get; set; }
         public bool timeHit { get; set; }
+        public bool boundHit { get; set; } // stopped at a solution shorter than SolverConfig.AbortBelowLength
     }
 
     public sealed class LevelHeader
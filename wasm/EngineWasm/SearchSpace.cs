@@ -0,0 +1,195 @@
+#if UNITY_EDITOR || EXPOSE_WASM
+using System;
+using SlimeGrid.Logic;
+
+namespace SlimeGrid.Tools.Solver
+{
+    // What the solver loops need from a state representation. Implemented by structs so
+    // each representation gets its own specialized copy of the search code.
+    internal interface ISearchSpace<TState>
+    {
+        TState Root { get; }
+        TState Step(in TState s, Dir d);
+        bool Win(in TState s);
+        bool GameOver(in TState s);
+        StateKey Key(in TState s);
+        GameState View(in TState s); // full state for DeadlockTable / DeadEndAnalyzer
+        void Pack(in TState s, StatePacker packer, Span<ulong> words);
+        // SolveGraph support. Reach: how far along the ray from the player the step s -> child can
+        // have read tiles. Every mover (player, attached or pushed entities, flights, slides)
+        // looks at most one cell past where it stopped, a push chain one past its last entity;
+        // falls and breaks lose the last position, so those count as the whole ray.
+        int Reach(in TState s, Dir d, in TState child);
+        bool Reads(in TState s, Dir d, int reach, int cell); // entity on cell, or cell within reach
+        bool Pressed(in TState s); // AnyButtonPressed the next step starts from
+        TState Adopt(in TState s); // a SolveGraph state of the level before a tile edit, rebound to this one
+        bool TryRoot(GameState start, out TState root); // another spawn of this level, in this space
+    }
+
+    // Reference path: cloned GameState + Engine.Step (no deltas)
+    internal readonly struct EngineSpace : ISearchSpace<GameState>
+    {
+        readonly LevelContext ctx;
+        readonly bool verify;
+        public GameState Root { get; }
+
+        public EngineSpace(GameState initial, LevelContext ctx, bool verify = false)
+        {
+            this.ctx = ctx;
+            this.verify = verify;
+            Root = BruteForceSolver.CloneRoot(initial);
+        }
+
+        public GameState Step(in GameState s, Dir d)
+        {
+            var child = BruteForceSolver.CloneState(s);
+            var sink = new NullStepSink();
+            Engine.Step(child, d, ref sink);
+            if (verify) VerifySinks(s, d, child);
+            return child;
+        }
+
+        // The recording sinks must reach the same state, and agree with each other on the deltas
+        void VerifySinks(GameState s, Dir d, GameState child)
+        {
+            var full = BruteForceSolver.CloneState(s);
+            var res = Engine.Step(full, d);
+            var counted = BruteForceSolver.CloneState(s);
+            var counter = new CountingStepSink();
+            Engine.Step(counted, d, ref counter);
+            var key = StateHasher.ComputeZobrist(child, ctx);
+            foreach (var g in new[] { full, counted })
+                if (!StateHasher.ComputeZobrist(g, ctx).Equals(key) || g.Win != child.Win || g.GameOver != child.GameOver || g.AnyButtonPressed != child.AnyButtonPressed)
+                    throw new InvalidOperationException($"NullStepSink step {d} diverged from Engine.Step");
+            if (counter.Count != res.Deltas.Count)
+                throw new InvalidOperationException($"Step {d}: CountingStepSink saw {counter.Count} deltas, StepResult {res.Deltas.Count}");
+        }
+
+        public bool Win(in GameState s) => s.Win;
+        public bool GameOver(in GameState s) => s.GameOver;
+        public StateKey Key(in GameState s) => StateHasher.ComputeZobrist(s, ctx);
+        public GameState View(in GameState s) => s;
+        public void Pack(in GameState s, StatePacker packer, Span<ulong> words) => packer.Pack(s, words);
+
+        public int Reach(in GameState s, Dir d, in GameState child)
+        {
+            if (child.EntitiesById.Count != s.EntitiesById.Count) return int.MaxValue;
+            var p = s.PlayerPos;
+            int far = SolveGraph.RayIndex(p.x, p.y, d, child.PlayerPos.x, child.PlayerPos.y);
+            foreach (var e in child.EntitiesById.Values)
+            {
+                if (s.EntitiesById[e.Id].Pos.Equals(e.Pos)) continue;
+                int k = SolveGraph.RayIndex(p.x, p.y, d, e.Pos.x, e.Pos.y);
+                if (k < 0) return int.MaxValue;
+                far = Math.Max(far, k);
+            }
+            if (far < 0) return int.MaxValue;
+            var v = d.Vec();
+            while (s.EntityAt.ContainsKey(new V2(p.x + (far + 1) * v.dx, p.y + (far + 1) * v.dy))) far++;
+            return far + 1;
+        }
+
+        public bool Reads(in GameState s, Dir d, int reach, int cell)
+        {
+            var c = new V2(cell % s.Grid.W, cell / s.Grid.W);
+            if (s.EntityAt.ContainsKey(c)) return true;
+            int k = SolveGraph.RayIndex(s.PlayerPos.x, s.PlayerPos.y, d, c.x, c.y);
+            return k >= 0 && k <= reach;
+        }
+
+        public bool Pressed(in GameState s) => s.AnyButtonPressed;
+
+        public GameState Adopt(in GameState s)
+        {
+            if (ReferenceEquals(s.Grid, Root.Grid)) return s;
+            var c = BruteForceSolver.CloneState(s);
+            c.Grid = Root.Grid;
+            c.Moves = Root.Moves;
+            ButtonCounters.Invalidate(c);
+            return c;
+        }
+
+        public bool TryRoot(GameState start, out GameState root)
+        {
+            root = Adopt(BruteForceSolver.CloneRoot(start));
+            return true;
+        }
+    }
+
+#if NET7_0_OR_GREATER
+    internal readonly struct BoardSpace<T> : ISearchSpace<BoardState<T>> where T : unmanaged, System.Numerics.IBinaryInteger<T>
+    {
+        readonly BitboardLevel<T> level;
+        readonly LevelContext ctx;
+        readonly bool verify;
+
+        public BoardSpace(BitboardLevel<T> level, LevelContext ctx, bool verify)
+        { this.level = level; this.ctx = ctx; this.verify = verify; }
+
+        public BoardState<T> Root => level.Root;
+
+        public BoardState<T> Step(in BoardState<T> s, Dir d)
+        {
+            var child = level.Step(in s, d);
+            if (verify)
+            {
+                var g = level.Expand(in s);
+                var sink = new NullStepSink();
+                Engine.Step(g, d, ref sink);
+                if (!level.Matches(g, in child) || !StateHasher.ComputeZobrist(g, ctx).Equals(level.Key(in child)))
+                    throw new InvalidOperationException($"Bitboard step {d} diverged from Engine.Step");
+            }
+            return child;
+        }
+
+        public bool Win(in BoardState<T> s) => s.Win;
+        public bool GameOver(in BoardState<T> s) => s.GameOver;
+        public StateKey Key(in BoardState<T> s) => level.Key(in s);
+        public GameState View(in BoardState<T> s) => level.Expand(in s);
+        public void Pack(in BoardState<T> s, StatePacker packer, Span<ulong> words) => level.Pack(in s, packer, words);
+        public int Reach(in BoardState<T> s, Dir d, in BoardState<T> child) => level.Reach(in s, d, in child);
+        public bool Reads(in BoardState<T> s, Dir d, int reach, int cell) => level.Reads(in s, d, reach, cell);
+        public bool Pressed(in BoardState<T> s) => s.AnyButtonPressed;
+        public BoardState<T> Adopt(in BoardState<T> s) => s; // positions only; tiles live in the level
+
+        public bool TryRoot(GameState start, out BoardState<T> root)
+        {
+            var b = BitboardLevel<T>.TryCreate(start);
+            root = b != null ? b.Root : default;
+            return b != null;
+        }
+    }
+#endif
+
+    // SolverConfig.ExactStateKeys: keys are arena ids of the exact packed state, so the
+    // visited set cannot merge distinct states. Everything else goes to the wrapped space.
+    internal readonly struct ExactSpace<TState, TInner> : ISearchSpace<TState> where TInner : struct, ISearchSpace<TState>
+    {
+        readonly TInner inner;
+        readonly ExactKeys keys;
+
+        public ExactSpace(TInner inner, ExactKeys keys) { this.inner = inner; this.keys = keys; }
+
+        public TState Root => inner.Root;
+        public TState Step(in TState s, Dir d) => inner.Step(in s, d);
+        public bool Win(in TState s) => inner.Win(in s);
+        public bool GameOver(in TState s) => inner.GameOver(in s);
+        public GameState View(in TState s) => inner.View(in s);
+        public void Pack(in TState s, StatePacker packer, Span<ulong> words) => inner.Pack(in s, packer, words);
+        public int Reach(in TState s, Dir d, in TState child) => inner.Reach(in s, d, in child);
+        public bool Reads(in TState s, Dir d, int reach, int cell) => inner.Reads(in s, d, reach, cell);
+        public bool Pressed(in TState s) => inner.Pressed(in s);
+        public TState Adopt(in TState s) => inner.Adopt(in s);
+        public bool TryRoot(GameState start, out TState root) => inner.TryRoot(start, out root);
+
+        public StateKey Key(in TState s)
+        {
+            Span<ulong> words = stackalloc ulong[keys.Packer.Words];
+            inner.Pack(in s, keys.Packer, words);
+            int id = keys.Arena.Intern(words, out bool added);
+            if (added && keys.CountsCollisions) keys.Record(id, inner.Key(in s));
+            return new StateKey((ulong)id, 0);
+        }
+    }
+}
+#endif
@@ -0,0 +1,115 @@
+using System;
+using System.Collections.Generic;
+
+namespace SlimeGrid.Tools.ALD
+{
+    // Seen-level gate for the exact dedupe check (InfluenceMask.CanonicalSignature values).
+    public interface ISignatureSet
+    {
+        string Mode { get; }
+        int Count { get; }
+        // Upper bound on the chance that an unseen signature is reported as seen (0 when exact).
+        double FalsePositiveRate { get; }
+        // false => (probably) seen before
+        bool Add(ulong sig);
+    }
+
+    public sealed class ExactSignatureSet : ISignatureSet
+    {
+        readonly HashSet<ulong> set = new();
+        public string Mode => "exact";
+        public int Count => set.Count;
+        public double FalsePositiveRate => 0;
+        public bool Add(ulong sig) => set.Add(sig);
+    }
+
+    // Scalable Bloom filter: when a stage fills up, a new one twice the size is added with half
+    // the error rate. Memory stays at a few bytes per signature (vs ~40 in a HashSet) and the
+    // compounded false-positive rate stays under the target however many candidates arrive.
+    public sealed class ScalableBloomFilter : ISignatureSet
+    {
+        sealed class Stage
+        {
+            public readonly ulong[] Bits;
+            public readonly ulong M;
+            public readonly int K;
+            public readonly int Capacity;
+            public int Count;
+
+            public Stage(int capacity, double p)
+            {
+                Capacity = capacity;
+                double ln2 = Math.Log(2);
+                M = (ulong)Math.Max(64, Math.Ceiling(-capacity * Math.Log(p) / (ln2 * ln2)));
+                K = Math.Max(1, (int)Math.Round(M / (double)capacity * ln2));
+                Bits = new ulong[(M + 63) / 64];
+            }
+
+            // Double hashing off the (already mixed) signature
+            public bool Contains(ulong h1, ulong h2)
+            {
+                for (int i = 0; i < K; i++)
+                {
+                    ulong b = (h1 + (ulong)i * h2) % M;
+                    if ((Bits[b >> 6] & (1UL << (int)(b & 63))) == 0) return false;
+                }
+                return true;
+            }
+
+            public void Set(ulong h1, ulong h2)
+            {
+                for (int i = 0; i < K; i++)
+                {
+                    ulong b = (h1 + (ulong)i * h2) % M;
+                    Bits[b >> 6] |= 1UL << (int)(b & 63);
+                }
+                Count++;
+            }
+
+            // Expected rate at the current fill: (1 - e^(-k n / m))^k
+            public double Rate => Math.Pow(1 - Math.Exp(-K * (double)Count / M), K);
+        }
+
+        readonly List<Stage> stages = new();
+        readonly double target;
+        int count;
+
+        public ScalableBloomFilter(double falsePositiveRate, int initialCapacity)
+        {
+            target = Math.Clamp(falsePositiveRate, 1e-9, 0.5);
+            stages.Add(new Stage(Math.Max(1024, initialCapacity), target / 2)); // stage rates sum to < target
+        }
+
+        public string Mode => "bloom";
+        public int Count => count;
+
+        public double FalsePositiveRate
+        {
+            get
+            {
+                double pass = 1;
+                foreach (var s in stages) pass *= 1 - s.Rate;
+                return 1 - pass;
+            }
+        }
+
+        public bool Add(ulong sig)
+        {
+            ulong h2 = sig * 0x9E3779B97F4A7C15UL;
+            h2 = (h2 ^ (h2 >> 29)) | 1;
+            foreach (var s in stages) if (s.Contains(sig, h2)) return false;
+
+            var last = stages[stages.Count - 1];
+            if (last.Count >= last.Capacity)
+            {
+                double p = target / 2;
+                for (int i = 0; i < stages.Count; i++) p /= 2;
+                last = new Stage(last.Capacity * 2, p);
+                stages.Add(last);
+            }
+            last.Set(sig, h2);
+            count++;
+            return true;
+        }
+    }
+}
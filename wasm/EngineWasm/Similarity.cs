@@ -40,77 +40,104 @@ namespace SlimeGrid.Tools.ALD
         // Layout similarity over influence mask
         public static float LayoutSimilarity(GameState a, GameState b, bool[,] mask, int spatialHashSize, float wTiles, float wEntities, float wSpatial)
         {
-            var histA = TileTraitHistogram(a, mask);
-            var histB = TileTraitHistogram(b, mask);
-            float dTiles = TotalVariation(histA, histB);
+            var fa = Layout(a, mask, spatialHashSize);
+            var fb = Layout(b, mask, spatialHashSize);
+            return LayoutSimilarity(fa, fb, wTiles, wEntities, wSpatial);
+        }
 
-            var entA = EntitySpectrum(a, mask);
-            var entB = EntitySpectrum(b, mask);
-            float dEnt = TotalVariation(entA, entB);
+        // Same distance over precomputed features (both built with the same hash size)
+        public static float LayoutSimilarity(LayoutFeatures a, LayoutFeatures b, float wTiles, float wEntities, float wSpatial)
+        {
+            float dTiles = TotalVariation(a.Tiles, b.Tiles);
+            float dEnt = TotalVariation(a.Entities, b.Entities);
+            float dSp = Hamming(a.Spatial, b.Spatial);
+            return wTiles * dTiles + wEntities * dEnt + wSpatial * dSp;
+        }
 
-            var spA = SpatialHash(a, mask, spatialHashSize);
-            var spB = SpatialHash(b, mask, spatialHashSize);
-            float dSp = Hamming(spA, spB);
+        // Candidate features, computed on first use and kept on the candidate
+        public static LayoutFeatures FeaturesOf(LevelCandidate c)
+        {
+            if (c.layout != null) return c.layout;
+            c.state ??= Loader.FromDTO(c.dto);
+            var mask = new bool[c.state.Grid.W, c.state.Grid.H];
+            for (int y = 0; y < c.state.Grid.H; y++) for (int x = 0; x < c.state.Grid.W; x++) mask[x, y] = true;
+            return c.layout = Layout(c.state, mask, LayoutFeatures.DefaultHashSize);
+        }
 
-            return wTiles * dTiles + wEntities * dEnt + wSpatial * dSp;
+        public static PackedMoves TopSolutionOf(LevelCandidate c)
+        {
+            if (c.topSolution.Buffer != null || c.report?.topSolutions == null || c.report.topSolutions.Count == 0) return c.topSolution;
+            var e = c.report.topSolutions[0];
+            return c.topSolution = new PackedMoves { Buffer = e.movesPacked, Length = e.length };
         }
 
-        static Dictionary<string, int> TileTraitHistogram(GameState s, bool[,] mask)
+        public static LayoutFeatures Layout(GameState s, bool[,] mask, int spatialHashSize) => new LayoutFeatures
+        {
+            Tiles = TileTraitHistogram(s, mask),
+            Entities = EntitySpectrum(s, mask),
+            Spatial = SpatialHash(s, mask, spatialHashSize),
+        };
+
+        // Histogram bins, in order: W, SE, SF, ST, HO, SL, EX, BT, BA
+        static readonly Traits[] TileBins =
         {
-            var d = new Dictionary<string, int>(32);
+            Traits.StopsPlayer, Traits.StopsEntity, Traits.StopsFlight, Traits.StopsTumble,
+            Traits.HoleForPlayer | Traits.HoleForEntity, Traits.Slipery, Traits.ExitPlayer,
+            Traits.ButtonToggle, Traits.ButtonAllowExit,
+        };
+
+        // Normalized counts (zeros when the mask covers nothing)
+        static float[] TileTraitHistogram(GameState s, bool[,] mask)
+        {
+            var d = new int[TileBins.Length];
             for (int y = 0; y < s.Grid.H; y++)
                 for (int x = 0; x < s.Grid.W; x++)
                 {
                     if (!mask[x, y]) continue;
-                    var m = s.Grid.CellRef(new V2(x, y)).ActiveMask; // authored traits
-                    Acc(d, "W", (m & Traits.StopsPlayer) != 0);
-                    Acc(d, "SE", (m & Traits.StopsEntity) != 0);
-                    Acc(d, "SF", (m & Traits.StopsFlight) != 0);
-                    Acc(d, "ST", (m & Traits.StopsTumble) != 0);
-                    Acc(d, "HO", (m & Traits.HoleForPlayer) != 0 || (m & Traits.HoleForEntity) != 0);
-                    Acc(d, "SL", (m & Traits.Slipery) != 0);
-                    Acc(d, "EX", (m & Traits.ExitPlayer) != 0);
-                    Acc(d, "BT", (m & Traits.ButtonToggle) != 0);
-                    Acc(d, "BA", (m & Traits.ButtonAllowExit) != 0);
+                    var m = s.Grid.Compiled.Active[y * s.Grid.W + x]; // authored traits
+                    for (int k = 0; k < TileBins.Length; k++)
+                        if ((m & TileBins[k]) != 0) d[k]++;
                 }
-            return d;
+            return Normalize(d);
         }
 
-        static Dictionary<string, int> EntitySpectrum(GameState s, bool[,] mask)
+        static readonly int EntityTypes = Enum.GetValues(typeof(EntityType)).Length;
+
+        // Bins by type and orientation
+        static float[] EntitySpectrum(GameState s, bool[,] mask)
         {
-            var d = new Dictionary<string, int>(32);
+            var d = new int[EntityTypes * 4];
             foreach (var kv in s.EntitiesById)
             {
                 var e = kv.Value;
                 var p = e.Pos;
                 if (!s.Grid.InBounds(p)) continue;
                 if (!mask[p.x, p.y]) continue;
-                string key = e.Type.ToString() + ":" + e.Orientation.ToString();
-                if (!d.TryGetValue(key, out var c)) d[key] = 1; else d[key] = c + 1;
+                d[(int)e.Type * 4 + (int)e.Orientation]++;
             }
-            return d;
+            return Normalize(d);
+        }
+
+        static float[] Normalize(int[] counts)
+        {
+            float sum = 0; foreach (var v in counts) sum += v;
+            var p = new float[counts.Length];
+            if (sum == 0) return p;
+            for (int i = 0; i < counts.Length; i++) p[i] = counts[i] / sum;
+            return p;
         }
 
-        static float TotalVariation(Dictionary<string, int> A, Dictionary<string, int> B)
+        static float TotalVariation(float[] A, float[] B)
         {
-            float sumA = 0, sumB = 0; foreach (var v in A.Values) sumA += v; foreach (var v in B.Values) sumB += v;
-            if (sumA == 0 && sumB == 0) return 0f;
-            var keys = new HashSet<string>(A.Keys); foreach (var k in B.Keys) keys.Add(k);
             float tv = 0f;
-            foreach (var k in keys)
-            {
-                float pa = A.TryGetValue(k, out var ca) ? (ca / sumA) : 0f;
-                float pb = B.TryGetValue(k, out var cb) ? (cb / sumB) : 0f;
-                tv += Math.Abs(pa - pb);
-            }
+            for (int i = 0; i < A.Length; i++) tv += Math.Abs(A[i] - B[i]);
             return 0.5f * tv;
         }
 
-        static byte[,] SpatialHash(GameState s, bool[,] mask, int N)
+        static byte[] SpatialHash(GameState s, bool[,] mask, int N)
         {
             int W = s.Grid.W, H = s.Grid.H;
-            var bins = new byte[N, N];
-            var count = new int[N, N];
+            var bins = new byte[N * N];
             for (int y = 0; y < H; y++)
                 for (int x = 0; x < W; x++)
                 {
@@ -119,23 +146,26 @@ namespace SlimeGrid.Tools.ALD
                     var t = s.Grid.CellRef(new V2(x, y)).Type;
                     byte code = (byte)(t == TileType.Wall ? 1 : t == TileType.Hole ? 2 : t == TileType.Exit ? 3 : 4);
                     if (s.EntityAt.ContainsKey(new V2(x, y))) code = (byte)(10 + code);
-                    bins[bx, by] ^= code; // lightweight mixing
-                    count[bx, by]++;
+                    bins[by * N + bx] ^= code; // lightweight mixing
                 }
             return bins;
         }
 
-        static float Hamming(byte[,] A, byte[,] B)
+        static float Hamming(byte[] A, byte[] B)
         {
-            int N = A.GetLength(0);
-            int diff = 0, tot = N * N;
-            for (int y = 0; y < N; y++)
-                for (int x = 0; x < N; x++)
-                    if (A[x, y] != B[x, y]) diff++;
-            return (float)diff / tot;
+            int diff = 0;
+            for (int i = 0; i < A.Length; i++)
+                if (A[i] != B[i]) diff++;
+            return (float)diff / A.Length;
         }
+    }
 
-        static void Acc(Dictionary<string, int> d, string k, bool on)
-        { if (!on) return; if (!d.TryGetValue(k, out var c)) d[k] = 1; else d[k] = c + 1; }
+    // What layout similarity compares: tile trait histogram, entity spectrum and spatial hash
+    public sealed class LayoutFeatures
+    {
+        public const int DefaultHashSize = 8;
+        public required float[] Tiles;
+        public required float[] Entities;
+        public required byte[] Spatial; // N×N, row-major
     }
 }
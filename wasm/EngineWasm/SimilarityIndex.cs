@@ -0,0 +1,122 @@
+using System;
+using System.Collections.Generic;
+using SlimeGrid.Tools.Solver;
+
+namespace SlimeGrid.Tools.ALD
+{
+    // Locality-sensitive index over a bucket's kept candidates, so PassSimilarity only measures
+    // the ones likely to be close instead of every item. Each candidate is filed under a few
+    // band keys: MinHash bands over the 3-grams of its top solution, bit-sampling bands over
+    // the layout spatial hash, and bands of finely binned tile/entity histograms on shifted
+    // grids. Query returns everything sharing a band with the candidate; near-duplicates
+    // almost always do. Approximate: a close item that shares no band is missed.
+    public sealed class SimilarityIndex
+    {
+        const int Shingle = 3;
+        const int SolBands = 12, SolRows = 2;
+        const int LayoutBands = 6, LayoutRows = 10;
+        const int HistBands = 4, HistBins = 32;
+
+        readonly Dictionary<ulong, HashSet<LevelCandidate>> table = new();
+        readonly HashSet<LevelCandidate> found = new();
+
+        public void Add(LevelCandidate c)
+        {
+            foreach (var k in KeysOf(c))
+            {
+                if (!table.TryGetValue(k, out var set)) table[k] = set = new HashSet<LevelCandidate>();
+                set.Add(c);
+            }
+        }
+
+        public void Remove(LevelCandidate c)
+        {
+            foreach (var k in KeysOf(c))
+            {
+                if (!table.TryGetValue(k, out var set)) continue;
+                set.Remove(c);
+                if (set.Count == 0) table.Remove(k);
+            }
+        }
+
+        // Distinct candidates sharing at least one band with c, in no particular order
+        public List<LevelCandidate> Near(LevelCandidate c, List<LevelCandidate> into)
+        {
+            into.Clear();
+            found.Clear();
+            foreach (var k in KeysOf(c))
+                if (table.TryGetValue(k, out var set))
+                    foreach (var item in set)
+                        if (found.Add(item)) into.Add(item);
+            return into;
+        }
+
+        // Band keys are deterministic per candidate, so they are kept on it like its features
+        static ulong[] KeysOf(LevelCandidate c)
+        {
+            if (c.bandKeys != null) return c.bandKeys;
+            var keys = new ulong[SolBands + LayoutBands + HistBands];
+            int k = 0;
+
+            // Solution: MinHash over move 3-grams (the whole solution when shorter)
+            var moves = Similarity.TopSolutionOf(c);
+            Span<ulong> min = stackalloc ulong[SolBands * SolRows];
+            min.Fill(ulong.MaxValue);
+            int grams = Math.Max(1, moves.Length - Shingle + 1);
+            for (int i = 0; i < grams; i++)
+            {
+                ulong g = (ulong)Math.Min(Shingle, moves.Length);
+                for (int j = i; j < i + Shingle && j < moves.Length; j++) g = g << 2 | moves.GetAt(j);
+                for (int h = 0; h < min.Length; h++)
+                {
+                    ulong v = Mix64(g + (ulong)(h + 1) * 0x9E3779B97F4A7C15UL);
+                    if (v < min[h]) min[h] = v;
+                }
+            }
+            for (int b = 0; b < SolBands; b++)
+            {
+                ulong v = (ulong)b;
+                for (int r = 0; r < SolRows; r++) v = Mix64(v ^ min[b * SolRows + r]);
+                keys[k++] = v;
+            }
+
+            // Layout: fixed samples of the spatial hash, then the binned histograms
+            var f = Similarity.FeaturesOf(c);
+            for (int b = 0; b < LayoutBands; b++)
+            {
+                ulong v = 0x100UL + (ulong)b;
+                for (int r = 0; r < LayoutRows; r++)
+                {
+                    int at = (int)(Mix64((ulong)(b * LayoutRows + r)) % (ulong)f.Spatial.Length);
+                    v = Mix64(v ^ ((ulong)at << 8 | f.Spatial[at]));
+                }
+                keys[k++] = v;
+            }
+
+            // Both histograms binned to HistBins levels, the grid shifted per band
+            for (int b = 0; b < HistBands; b++)
+            {
+                float shift = (float)b / HistBands;
+                keys[k++] = Binned(Binned(0x200UL + (ulong)b, f.Tiles, shift), f.Entities, shift);
+            }
+            return c.bandKeys = keys;
+        }
+
+        static ulong Binned(ulong v, float[] hist, float shift)
+        {
+            v = Mix64(v ^ (ulong)hist.Length);
+            foreach (var share in hist) v = Mix64(v ^ (ulong)(int)(share * HistBins + shift));
+            return v;
+        }
+
+        static ulong Mix64(ulong x)
+        {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdUL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53UL;
+            x ^= x >> 33;
+            return x;
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#if UNITY_EDITOR || EXPOSE_WASM
+using System;
+using SlimeGrid.Logic;
+
+namespace SlimeGrid.Tools.Solver
+{
+    // Explored graph of one AnalyzeBfs run (or ExploreBfs over several spawns), for solving
+    // the same level again from another spawn or after a one-cell tile edit. A step only
+    // reads tiles under entities (falls, buttons, toggles, key terms) and on the ray from the
+    // player in the move direction, up to the child's recorded reach.
+    // A recorded child stays valid unless the edited cell is one of those; every other child
+    // is taken as recorded and only the rest is stepped again.
+    // Keeps all explored states alive: a few times the memory of the visited set.
+    public sealed class SolveGraph
+    {
+        internal readonly int W, H;
+        internal readonly Traits[] Active, Toggle;
+        internal readonly ulong[] Layout; // entity slots (EntitiesById order): type, orientation, behavior, traits
+        internal readonly object Expansions; // Dictionary<NodeKey, GraphChild<TState>[]>, children in DIRS order
+
+        internal SolveGraph(GameState level, object expansions)
+        {
+            W = level.Grid.W; H = level.Grid.H;
+            Active = new Traits[W * H]; Toggle = new Traits[W * H];
+            for (int i = 0; i < W * H; i++)
+            {
+                ref readonly var c = ref level.Grid.CellRef(new V2(i % W, i / W));
+                Active[i] = c.ActiveMask; Toggle[i] = c.ToggleMask;
+            }
+            Layout = LayoutOf(level);
+            Expansions = expansions;
+        }
+
+        // States only carry entity positions; what each slot is comes from the level
+        internal static ulong[] LayoutOf(GameState level)
+        {
+            var l = new ulong[level.EntitiesById.Count * 2];
+            int k = 0;
+            foreach (var e in level.EntitiesById.Values)
+            {
+                l[k++] = (ulong)e.Type | (ulong)e.Orientation << 8 | (ulong)e.Behavior << 16;
+                l[k++] = (ulong)e.Traits;
+            }
+            return l;
+        }
+
+        public int ExpandedCount => ((System.Collections.ICollection)Expansions).Count;
+
+        // The single cell whose tile differs in `level` (-1 when none); false when the graph
+        // cannot be reused: other dimensions or entities, several edits, or an allow-exit button
+        // added or removed (every win check reads all of those). The spawn may differ.
+        internal bool TryFindEdit(GameState level, out int cell)
+        {
+            cell = -1;
+            if (level.Grid.W != W || level.Grid.H != H) return false;
+            if (!((ReadOnlySpan<ulong>)LayoutOf(level)).SequenceEqual(Layout)) return false;
+            for (int i = 0; i < W * H; i++)
+            {
+                ref readonly var c = ref level.Grid.CellRef(new V2(i % W, i / W));
+                if (c.ActiveMask == Active[i] && c.ToggleMask == Toggle[i]) continue;
+                if (cell >= 0) return false;
+                if (((c.ActiveMask | c.ToggleMask | Active[i] | Toggle[i]) & Traits.ButtonAllowExit) != 0) return false;
+                cell = i;
+            }
+            return true;
+        }
+
+        // Expansions are keyed by the state key and the pressed flag the step starts from: the
+        // flag is carried over from the previous step, so it can lag the positions the key sees.
+        internal static StateKey NodeKey(StateKey key, bool pressed) =>
+            pressed ? new StateKey(key.A ^ 0x9E3779B97F4A7C15UL, key.B ^ 0xC2B2AE3D27D4EB4FUL) : key;
+
+        // Position of (x, y) on the ray from (px, py) toward d: 0 = the start, -1 = off the ray.
+        internal static int RayIndex(int px, int py, Dir d, int x, int y)
+        {
+            var v = d.Vec();
+            int k = v.dx == 0
+                ? (x == px ? (y - py) * v.dy : -1)
+                : (y == py ? (x - px) * v.dx : -1);
+            return k >= 0 ? k : -1;
+        }
+    }
+
+    internal struct GraphChild<TState>
+    {
+        public TState State;
+        public StateKey Key;
+        public int Reach; // ray cells 0..Reach may have been read (ISearchSpace.Reach)
+        public bool Win, GameOver;
+    }
+}
+#endif
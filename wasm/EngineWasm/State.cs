@@ -11,21 +11,29 @@ namespace SlimeGrid.Logic
     {
         public readonly int W;
         public readonly int H;
-        private readonly Cell[] _cells;
+        private readonly Cell[] _cells; // row-major, inline structs (default = Floor, no masks)
+
+        // Flat trait planes; every cell write must go through SetCell to keep it current
+        public readonly CompiledLevel Compiled;
 
         public Grid2D(int w, int h)
         {
             W = w; H = h;
             _cells = new Cell[W * H];
-            for (int i = 0; i < _cells.Length; i++)
-                _cells[i] = new Cell(); // Core.Cell (from Core.cs)
+            Compiled = new CompiledLevel(w, h);
         }
 
         public bool InBounds(V2 p) => p.x >= 0 && p.y >= 0 && p.x < W && p.y < H;
 
-        public ref Cell CellRef(V2 p) => ref _cells[p.y * W + p.x];
+        // Read-only view; edit a copy and write it back with SetCell
+        public ref readonly Cell CellRef(V2 p) => ref _cells[p.y * W + p.x];
 
-        public void SetCell(V2 p, in Cell c) => _cells[p.y * W + p.x] = c;
+        public void SetCell(V2 p, in Cell c)
+        {
+            int i = p.y * W + p.x;
+            _cells[i] = c;
+            Compiled.Refresh(i, c);
+        }
     }
 
     // ---------- Entity (single model; id != type) ----------------------------
@@ -74,6 +82,15 @@ namespace SlimeGrid.Logic
         public bool GameOver;
         public bool Win;
 
+        // Solver fast path (null in normal play): shared per-level slide/flight tables and
+        // entity occupancy bits kept in sync with EntityAt by Mechanics/Engine.
+        public MoveTables? Moves;
+        public ulong[]? Occupancy;
+
+        // Pressed-button counters (see ButtonCounters); -1 version => recount on next read
+        public int PressedToggleButtons;
+        public int PressedAllowExitButtons;
+        public int ButtonsVersion = -1;
 
         // Convenience
         public bool HasEntityAt(V2 p) => EntityAt.ContainsKey(p);
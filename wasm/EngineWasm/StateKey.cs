@@ -1,5 +1,6 @@
 #if UNITY_EDITOR || EXPOSE_WASM
 using System;
+using System.Buffers;
 using System.Collections.Generic;
 using SlimeGrid.Logic;
 
@@ -50,7 +51,7 @@ namespace SlimeGrid.Tools.Solver
             for (int x = 0; x < grid.W; x++)
             {
                 var p = new V2(x, y);
-                ref var c = ref grid.CellRef(p);
+                ref readonly var c = ref grid.CellRef(p);
                 if (c.ToggleMask == 0) continue;
                 var active = c.ActiveMask;
                 bool byButton = (active & Traits.ToggleableByButton) != 0;
@@ -64,57 +65,74 @@ namespace SlimeGrid.Tools.Solver
 
         static bool ComputeAnyButtonPressed(GameState s)
         {
+            if (s.Grid.Compiled.ButtonsStatic) return ButtonCounters.AnyTogglePressed(s);
+
             foreach (var kv in s.EntitiesById)
             {
                 var e = kv.Value;
                 if ((e.Traits & Traits.PressesButtons) == 0) continue;
                 // Avoid parity read; ButtonToggle bit is static in ActiveMask recipe.
-                if ((s.Grid.CellRef(e.Pos).ActiveMask & Traits.ButtonToggle) != 0)
+                if ((s.Grid.Compiled.Active[e.Pos.y * s.Grid.W + e.Pos.x] & Traits.ButtonToggle) != 0)
                     return true;
             }
             return false;
         }
 
+        // Canonical entity key: Type | x | y | Orientation, most significant first so that
+        // plain ulong order equals the (Type, Pos.x, Pos.y, Orientation) ordering.
+        static ulong EntityKey(Entity e) =>
+            ((ulong)(byte)e.Type << 56) | ((ulong)((uint)e.Pos.x & 0xFFFFF) << 36) |
+            ((ulong)((uint)e.Pos.y & 0xFFFFF) << 16) | ((ulong)(byte)e.Orientation << 8);
+
+        const int StackallocEntities = 128;
+
         public static StateKey Compute(GameState s, LevelContext ctx)
         {
             // Two parallel FNV hashes for low collision risk.
             ulong h1 = FNV_OFFSET;
             ulong h2 = 0xCBF29CE484222325UL; // different offset
 
-            // 1) Canonicalize entities by (Type, Pos.x, Pos.y, Orientation, Traits)
-            var tmp = s.EntitiesById.Count > 0 ? new List<Entity>(s.EntitiesById.Count) : new List<Entity>();
-            foreach (var kv in s.EntitiesById) tmp.Add(kv.Value);
-            tmp.Sort((a, b) =>
+            // 1) Canonicalize entities by (Type, Pos.x, Pos.y, Orientation) via packed keys;
+            //    cells hold at most one entity, so keys are unique and identify the attached one.
+            int n = s.EntitiesById.Count;
+            ulong[]? rented = null;
+            Span<ulong> keys = n <= StackallocEntities
+                ? stackalloc ulong[StackallocEntities]
+                : (rented = ArrayPool<ulong>.Shared.Rent(n));
+            keys = keys.Slice(0, n);
+
+            int k = 0;
+            ulong attachedKey = 0; bool hasAttached = false;
+            foreach (var kv in s.EntitiesById)
             {
-                int c = ((int)a.Type).CompareTo((int)b.Type);
-                if (c != 0) return c;
-                c = a.Pos.x.CompareTo(b.Pos.x); if (c != 0) return c;
-                c = a.Pos.y.CompareTo(b.Pos.y); if (c != 0) return c;
-                c = ((int)a.Orientation).CompareTo((int)b.Orientation); if (c != 0) return c;
-                return 0; // ignore Traits for canonical ordering
-            });
-
-            // Map entity id -> canonical index
-            var idToIdx = new Dictionary<int, int>(tmp.Count);
-            for (int i = 0; i < tmp.Count; i++) idToIdx[tmp[i].Id] = i;
+                var key = EntityKey(kv.Value);
+                keys[k++] = key;
+                if (s.AttachedEntityId == kv.Key) { attachedKey = key; hasAttached = true; }
+            }
+            keys.Sort();
 
             // 2) Player core fields
             Mix(ref h1, (ulong)(uint)s.PlayerPos.x); Mix(ref h2, (ulong)(uint)s.PlayerPos.y);
-            int attachedIdx = s.AttachedEntityId.HasValue && idToIdx.TryGetValue(s.AttachedEntityId.Value, out var idx) ? idx : -1;
+            int attachedIdx = hasAttached ? keys.BinarySearch(attachedKey) : -1;
             Mix(ref h1, (ulong)(attachedIdx + 1)); // -1 -> 0
             Mix(ref h2, (ulong)(s.EntryDir.HasValue ? (byte)s.EntryDir.Value + 1 : 0));
 
             // 3) Canonical entity list
-            foreach (var e in tmp)
+            foreach (var key in keys)
             {
-                Mix(ref h1, (ulong)(byte)e.Type);
-                Mix(ref h1, (ulong)(uint)e.Pos.x); Mix(ref h1, (ulong)(uint)e.Pos.y);
-                Mix(ref h1, (ulong)(byte)e.Orientation);
+                ulong type = key >> 56;
+                uint x = (uint)(key >> 36) & 0xFFFFF, y = (uint)(key >> 16) & 0xFFFFF;
+                ulong orient = (key >> 8) & 0xFF;
+
+                Mix(ref h1, type);
+                Mix(ref h1, x); Mix(ref h1, y);
+                Mix(ref h1, orient);
 
-                Mix(ref h2, (ulong)(byte)e.Type * 1315423911UL);
-                Mix(ref h2, (ulong)(((uint)e.Pos.x << 16) ^ (uint)(e.Pos.y)));
-                Mix(ref h2, (ulong)(byte)e.Orientation * 1099511628211UL);
+                Mix(ref h2, type * 1315423911UL);
+                Mix(ref h2, (ulong)((x << 16) ^ y));
+                Mix(ref h2, orient * 1099511628211UL);
             }
+            if (rented != null) ArrayPool<ulong>.Shared.Return(rented);
 
             // 4) Toggle parity signature (derived from positions)
             bool anyBtn = ComputeAnyButtonPressed(s);
@@ -133,79 +151,98 @@ namespace SlimeGrid.Tools.Solver
         // Zobrist-style hasher (order-insensitive, low allocation). Designed for speed.
         public static StateKey ComputeZobrist(GameState s, LevelContext ctx)
         {
-            ulong h1 = 0x9E3779B97F4A7C15UL; // different offsets for each stream
-            ulong h2 = 0xC2B2AE3D27D4EB4FUL;
-
-            static ulong Mix64(ulong x)
-            {
-                x ^= x >> 33;
-                x *= 0xff51afd7ed558ccdUL;
-                x ^= x >> 33;
-                x *= 0xc4ceb9fe1a85ec53UL;
-                x ^= x >> 33;
-                return x;
-            }
-            static void XorMix(ref ulong h, ulong v)
-            {
-                h ^= Mix64(v + 0x9E3779B97F4A7C15UL);
-            }
-
-            // Player position + attachment + entryDir (small signature)
-            unchecked
-            {
-                ulong p = ((ulong)(uint)s.PlayerPos.x << 32) ^ (ulong)(uint)s.PlayerPos.y;
-                XorMix(ref h1, p ^ 0xA5A5A5A5A5A5A5A5UL);
-                XorMix(ref h2, p ^ 0x5A5A5A5A5A5A5A5AUL);
-                int ed = s.EntryDir.HasValue ? ((int)s.EntryDir.Value + 1) : 0;
-                int att = s.AttachedEntityId.HasValue ? 1 : 0;
-                XorMix(ref h1, (ulong)((ed & 0xFF) | ((att & 0xFF) << 8)));
-                XorMix(ref h2, (ulong)((att & 0xFF) | ((ed & 0xFF) << 8)));
-            }
+            var z = new Zobrist();
+            z.Player(s.PlayerPos, s.EntryDir, s.AttachedEntityId.HasValue);
 
             // Entities: order-insensitive xor over type,pos,orientation
             foreach (var kv in s.EntitiesById)
             {
                 var e = kv.Value;
-                ulong v = 0;
-                v ^= (ulong)(byte)e.Type;
-                v ^= (ulong)(((uint)e.Pos.x << 16) ^ (uint)e.Pos.y);
-                v ^= (ulong)(byte)e.Orientation << 24;
-                XorMix(ref h1, v);
-                XorMix(ref h2, v * 1315423911UL);
+                z.Entity(e.Type, e.Pos, e.Orientation);
             }
 
             // Toggle parity signature (sparse):
             // - Mix a single bit for AnyButtonPressed (affects all Button-toggleable tiles uniformly)
             // - Mix only positions currently toggled by entity occupancy
             // - Player parity is implied by PlayerPos; add an extra bit if that cell is ToggleableByPlayer
-            bool anyBtn = ComputeAnyButtonPressed(s);
-            XorMix(ref h1, anyBtn ? 0xABCDEF01UL : 0x10FEDCBAUL);
-            XorMix(ref h2, anyBtn ? 0x0123456789ABCDEFUL : 0xFEDCBA9876543210UL);
+            z.Buttons(ComputeAnyButtonPressed(s));
 
             // Entity-triggered toggles at occupied positions
             foreach (var kv in s.EntitiesById)
             {
                 var pos = kv.Value.Pos;
-                ref var c = ref s.Grid.CellRef(pos);
-                if ((c.ActiveMask & Traits.ToggleableByEntity) != 0)
-                {
-                    ulong pv = ((ulong)(uint)pos.x << 32) ^ (ulong)(uint)pos.y;
-                    XorMix(ref h1, pv ^ 0xC001D00DUL);
-                    XorMix(ref h2, pv ^ 0x00D1C0DEUL);
-                }
+                if ((s.Grid.Compiled.Active[pos.y * s.Grid.W + pos.x] & Traits.ToggleableByEntity) != 0)
+                    z.EntityToggle(pos);
             }
             // Player-triggered toggle at player cell (optional bit)
+            if ((s.Grid.Compiled.Active[s.PlayerPos.y * s.Grid.W + s.PlayerPos.x] & Traits.ToggleableByPlayer) != 0)
+                z.PlayerToggle();
+
+            return z.Key;
+        }
+    }
+
+    // Accumulator behind ComputeZobrist; other state layouts (bitboards) feed it the same
+    // terms so their keys are interchangeable with GameState keys.
+    internal struct Zobrist
+    {
+        ulong h1, h2;
+
+        public Zobrist()
+        {
+            h1 = 0x9E3779B97F4A7C15UL; // different offsets for each stream
+            h2 = 0xC2B2AE3D27D4EB4FUL;
+        }
+
+        static ulong Mix64(ulong x)
+        {
+            x ^= x >> 33;
+            x *= 0xff51afd7ed558ccdUL;
+            x ^= x >> 33;
+            x *= 0xc4ceb9fe1a85ec53UL;
+            x ^= x >> 33;
+            return x;
+        }
+
+        void Mix(ulong v1, ulong v2)
+        {
+            h1 ^= Mix64(v1 + 0x9E3779B97F4A7C15UL);
+            h2 ^= Mix64(v2 + 0x9E3779B97F4A7C15UL);
+        }
+
+        // Player position + attachment + entryDir (small signature)
+        public void Player(V2 pos, Dir? entryDir, bool attached)
+        {
+            unchecked
             {
-                ref var pc = ref s.Grid.CellRef(s.PlayerPos);
-                if ((pc.ActiveMask & Traits.ToggleableByPlayer) != 0)
-                {
-                    XorMix(ref h1, 0xBEEFCAFEUL);
-                    XorMix(ref h2, 0xFACEB00CUL);
-                }
+                ulong p = ((ulong)(uint)pos.x << 32) ^ (ulong)(uint)pos.y;
+                Mix(p ^ 0xA5A5A5A5A5A5A5A5UL, p ^ 0x5A5A5A5A5A5A5A5AUL);
+                int ed = entryDir.HasValue ? ((int)entryDir.Value + 1) : 0;
+                int att = attached ? 1 : 0;
+                Mix((ulong)((ed & 0xFF) | ((att & 0xFF) << 8)), (ulong)((att & 0xFF) | ((ed & 0xFF) << 8)));
             }
+        }
 
-            return new StateKey(h1, h2);
+        public void Entity(EntityType type, V2 pos, Orientation o)
+        {
+            // Disjoint fields: overlapping type and y bits made swapped entities cancel out.
+            ulong v = ((ulong)(byte)type << 56) | ((ulong)(byte)o << 48) |
+                      ((ulong)((uint)pos.x & 0xFFFFFF) << 24) | ((uint)pos.y & 0xFFFFFF);
+            Mix(v, v * 1315423911UL);
+        }
+
+        public void Buttons(bool anyPressed)
+            => Mix(anyPressed ? 0xABCDEF01UL : 0x10FEDCBAUL, anyPressed ? 0x0123456789ABCDEFUL : 0xFEDCBA9876543210UL);
+
+        public void EntityToggle(V2 pos)
+        {
+            ulong pv = ((ulong)(uint)pos.x << 32) ^ (ulong)(uint)pos.y;
+            Mix(pv ^ 0xC001D00DUL, pv ^ 0x00D1C0DEUL);
         }
+
+        public void PlayerToggle() => Mix(0xBEEFCAFEUL, 0xFACEB00CUL);
+
+        public StateKey Key => new StateKey(h1, h2);
     }
 }
 #endif
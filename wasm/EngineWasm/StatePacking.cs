@@ -0,0 +1,219 @@
+#if UNITY_EDITOR || EXPOSE_WASM
+using System;
+using System.Collections.Generic;
+using SlimeGrid.Logic;
+
+namespace SlimeGrid.Tools.Solver
+{
+    // Exact, bit-packed state encoding (no hashing, so no collisions):
+    //   player cell | attached flag | entry dir | per (type, orientation) group: sorted entity cells
+    // Type and orientation never change during play, so each group keeps the root's slot count
+    // and removed entities become a sentinel cell that sorts last. The attached entity is the
+    // one on the player's cell and toggles derive from positions, so this covers everything the
+    // Zobrist key hashes. Levels whose encoding exceeds MaxBits are refused (TryCreate => null).
+    public sealed class StatePacker
+    {
+        public const int MaxBits = 1024;
+
+        readonly int W;
+        readonly int cellBits;
+        readonly int sentinel;
+        readonly int[] groupKey;   // (type << 8) | orientation, one per group
+        readonly int[] groupStart; // first slot of each group, plus the slot count at the end
+        readonly int[] fill;       // next free slot per group while packing
+        readonly int[] cells;      // scratch: sorted cells per slot
+        public readonly int Bits;
+        public readonly int Bytes;
+        public readonly int Words;
+
+        StatePacker(int w, int cellBits, int sentinel, int[] groupKey, int[] groupStart)
+        {
+            W = w;
+            this.cellBits = cellBits;
+            this.sentinel = sentinel;
+            this.groupKey = groupKey;
+            this.groupStart = groupStart;
+            fill = new int[groupKey.Length];
+            int slots = groupStart[groupKey.Length];
+            cells = new int[slots];
+            Bits = cellBits + 1 + 3 + slots * cellBits;
+            Bytes = (Bits + 7) >> 3;
+            Words = (Bits + 63) >> 6;
+        }
+
+        static int GroupKey(EntityType t, Orientation o) => ((byte)t << 8) | (byte)o;
+
+        public static StatePacker? TryCreate(GameState root)
+        {
+            int n = root.Grid.W * root.Grid.H;
+            int cellBits = 1;
+            while ((1 << cellBits) <= n) cellBits++; // n itself is the sentinel
+
+            var counts = new SortedDictionary<int, int>();
+            foreach (var kv in root.EntitiesById)
+            {
+                int key = GroupKey(kv.Value.Type, kv.Value.Orientation);
+                counts.TryGetValue(key, out var c);
+                counts[key] = c + 1;
+            }
+            var keys = new int[counts.Count];
+            var start = new int[counts.Count + 1];
+            int g = 0, slots = 0;
+            foreach (var kv in counts) { keys[g] = kv.Key; start[g++] = slots; slots += kv.Value; }
+            start[g] = slots;
+
+            if (cellBits + 1 + 3 + slots * cellBits > MaxBits) return null;
+            return new StatePacker(root.Grid.W, cellBits, n, keys, start);
+        }
+
+        public void Begin()
+        {
+            for (int g = 0; g < fill.Length; g++) fill[g] = groupStart[g];
+        }
+
+        public void Add(EntityType type, Orientation o, int cell)
+        {
+            int key = GroupKey(type, o);
+            int g = 0;
+            while (g < groupKey.Length && groupKey[g] != key) g++;
+            if (g == groupKey.Length || fill[g] == groupStart[g + 1])
+                throw new InvalidOperationException($"StatePacker: {type}/{o} not in the root's entity set");
+
+            // Insertion keeps the group sorted; groups are a handful of entities.
+            int i = fill[g]++;
+            while (i > groupStart[g] && cells[i - 1] > cell) { cells[i] = cells[i - 1]; i--; }
+            cells[i] = cell;
+        }
+
+        public void Finish(int playerCell, bool attached, Dir? entryDir, Span<ulong> words)
+        {
+            words.Slice(0, Words).Clear();
+            int bit = 0;
+            Put(words, ref bit, (uint)playerCell, cellBits);
+            Put(words, ref bit, attached ? 1u : 0u, 1);
+            Put(words, ref bit, entryDir.HasValue ? (uint)entryDir.Value + 1 : 0u, 3);
+            for (int g = 0; g < groupKey.Length; g++)
+            {
+                for (int i = groupStart[g]; i < fill[g]; i++) Put(words, ref bit, (uint)cells[i], cellBits);
+                for (int i = fill[g]; i < groupStart[g + 1]; i++) Put(words, ref bit, (uint)sentinel, cellBits);
+            }
+        }
+
+        public void Pack(GameState s, Span<ulong> words)
+        {
+            Begin();
+            foreach (var kv in s.EntitiesById)
+            {
+                var e = kv.Value;
+                Add(e.Type, e.Orientation, e.Pos.y * W + e.Pos.x);
+            }
+            Finish(s.PlayerPos.y * W + s.PlayerPos.x, s.AttachedEntityId.HasValue, s.EntryDir, words);
+        }
+
+        static void Put(Span<ulong> words, ref int bit, uint v, int width)
+        {
+            int w = bit >> 6, o = bit & 63;
+            words[w] |= (ulong)v << o;
+            if (o + width > 64) words[w + 1] |= (ulong)v >> (64 - o);
+            bit += width;
+        }
+    }
+
+    // Append-only store of packed states (Bytes each) with an open-addressing index.
+    // Intern hands out dense ids; equal encodings always get the same id.
+    public sealed class StateArena
+    {
+        readonly int size;
+        byte[] data;
+        int[] table; // id + 1 per bucket, 0 => empty
+        int count;
+
+        public int Count => count;
+        public long BytesUsed => (long)count * size;
+
+        public StateArena(int bytesPerState, int capacity = 4096)
+        {
+            size = bytesPerState;
+            data = new byte[Math.Max(1, capacity * size)];
+            int t = 16;
+            while (t < capacity * 2) t <<= 1;
+            table = new int[t];
+        }
+
+        static ulong Hash(ReadOnlySpan<ulong> words)
+        {
+            ulong h = 0x9E3779B97F4A7C15UL;
+            foreach (var w in words)
+            {
+                h ^= w;
+                h *= 0xff51afd7ed558ccdUL;
+                h ^= h >> 32;
+            }
+            return h;
+        }
+
+        // words: StatePacker output; only the first bytesPerState bytes are significant.
+        public int Intern(ReadOnlySpan<ulong> words, out bool added)
+        {
+            var bytes = System.Runtime.InteropServices.MemoryMarshal.AsBytes(words).Slice(0, size);
+            int mask = table.Length - 1;
+            int b = (int)Hash(words) & mask;
+            while (table[b] != 0)
+            {
+                int id = table[b] - 1;
+                if (bytes.SequenceEqual(new ReadOnlySpan<byte>(data, id * size, size))) { added = false; return id; }
+                b = (b + 1) & mask;
+            }
+
+            if ((count + 1) * size > data.Length) Array.Resize(ref data, data.Length * 2);
+            bytes.CopyTo(new Span<byte>(data, count * size, size));
+            table[b] = ++count;
+            if (count * 2 > table.Length) Rehash(words.Length);
+            added = true;
+            return count - 1;
+        }
+
+        void Rehash(int words)
+        {
+            var next = new int[table.Length * 2];
+            int mask = next.Length - 1;
+            Span<ulong> scratch = stackalloc ulong[words];
+            var scratchBytes = System.Runtime.InteropServices.MemoryMarshal.AsBytes(scratch);
+            for (int id = 0; id < count; id++)
+            {
+                scratch.Clear();
+                new ReadOnlySpan<byte>(data, id * size, size).CopyTo(scratchBytes);
+                int b = (int)Hash(scratch) & mask;
+                while (next[b] != 0) b = (b + 1) & mask;
+                next[b] = id + 1;
+            }
+            table = next;
+        }
+    }
+
+    // Per-search state for SolverConfig.ExactStateKeys: arena ids replace hashed keys, and
+    // optionally every new state's Zobrist key is recorded to count how often two distinct
+    // states would have shared one (states the hashed visited set silently merges).
+    internal sealed class ExactKeys
+    {
+        public readonly StatePacker Packer;
+        public readonly StateArena Arena;
+        readonly Dictionary<StateKey, int>? zobristOwner; // only when counting collisions
+        public int ZobristCollisions;
+
+        public ExactKeys(StatePacker packer, bool countCollisions)
+        {
+            Packer = packer;
+            Arena = new StateArena(packer.Bytes);
+            if (countCollisions) zobristOwner = new Dictionary<StateKey, int>(4096);
+        }
+
+        public bool CountsCollisions => zobristOwner != null;
+
+        public void Record(int id, StateKey zobrist)
+        {
+            if (zobristOwner != null && !zobristOwner.TryAdd(zobrist, id)) ZobristCollisions++;
+        }
+    }
+}
+#endif
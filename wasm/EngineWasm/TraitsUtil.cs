@@ -10,15 +10,15 @@ namespace SlimeGrid.Logic
             if (!s.Grid.InBounds(p))
                 return Traits.StopsPlayer | Traits.StopsEntity | Traits.StopsFlight;
 
-            ref var cell = ref s.Grid.CellRef(p);
-            Traits m = cell.ActiveMask;
+            var lvl = s.Grid.Compiled;
+            int i = p.y * lvl.W + p.x;
+            Traits m = lvl.ButtonPlane(i, s.AnyButtonPressed);
+            if (!lvl.IsDynamic(i)) return m;
 
-            if (cell.ToggleMask != 0)
-            {
-                if ((m & Traits.ToggleableByButton) != 0 && s.AnyButtonPressed) m ^= cell.ToggleMask;
-                if ((m & Traits.ToggleableByEntity) != 0 && s.EntityAt.ContainsKey(p)) m ^= cell.ToggleMask;
-                if ((m & Traits.ToggleableByPlayer) != 0 && p.Equals(s.PlayerPos)) m ^= cell.ToggleMask;
-            }
+            // Presence toggles apply on top of the button parity, in the same order as authored
+            var t = lvl.Toggle[i];
+            if ((m & Traits.ToggleableByEntity) != 0 && s.EntityAt.ContainsKey(p)) m ^= t;
+            if ((m & Traits.ToggleableByPlayer) != 0 && p.Equals(s.PlayerPos)) m ^= t;
             return m;
         }
 